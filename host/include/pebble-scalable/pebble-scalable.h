@@ -0,0 +1,30 @@
+//! @file pebble-scalable.h
+//! @brief Stand-in for the pebble-scalable package on the host build
+//!
+//! Scales values given in thousandths of the display size, and picks the
+//! font registered for the platform being built, matching the package.
+//!
+//! @author agent
+//! @date October 16, 2026
+
+#pragma once
+#include <pebble.h>
+
+//! Fonts to use on each group of platforms
+typedef struct {
+  GFont o; //< Every platform not listed below
+  GFont e; //< Emery
+  GFont g; //< Gabbro
+} SFontDistinct;
+
+//! Scale a value given in thousandths of the display width
+#define scl_x(thousandths) ((int)(thousandths) * PBL_DISPLAY_WIDTH / 1000)
+//! Scale a value given in thousandths of the display height
+#define scl_y(thousandths) ((int)(thousandths) * PBL_DISPLAY_HEIGHT / 1000)
+
+//! Register the fonts to use for an id on each group of platforms
+#define scl_set_fonts(id, ...) scl_set_fonts_distinct(id, (SFontDistinct)__VA_ARGS__)
+void scl_set_fonts_distinct(int id, SFontDistinct fonts);
+
+//! Get the font registered for an id on this platform
+GFont scl_get_font(int id);
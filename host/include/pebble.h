@@ -0,0 +1,406 @@
+//! @file pebble.h
+//! @brief Stand-in for the Pebble SDK header on the host build
+//!
+//! Declares the subset of the Pebble SDK which the app uses, so its modules
+//! compile and run in a normal Linux build. The implementation in
+//! pebble_host.c runs on a virtual clock with a deterministic AppTimer queue,
+//! an in-memory persist store, and records vibes and wakeups. pebble_host.h
+//! has the controls for driving it. Platform features come from the same
+//! PBL_* defines as the SDK, which the Makefile sets per platform.
+//!
+//! @author agent
+//! @date October 16, 2026
+
+#pragma once
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Platform
+//
+
+#ifndef PBL_DISPLAY_WIDTH
+#error "Build through host/Makefile, which defines the platform and its display size"
+#endif
+
+#ifdef PBL_COLOR
+#define PBL_IF_COLOR_ELSE(if_true, if_false) (if_true)
+#define PBL_IF_BW_ELSE(if_true, if_false) (if_false)
+#else
+#define PBL_IF_COLOR_ELSE(if_true, if_false) (if_false)
+#define PBL_IF_BW_ELSE(if_true, if_false) (if_true)
+#endif
+#ifdef PBL_ROUND
+#define PBL_IF_ROUND_ELSE(if_true, if_false) (if_true)
+#define PBL_IF_RECT_ELSE(if_true, if_false) (if_false)
+#else
+#define PBL_IF_ROUND_ELSE(if_true, if_false) (if_false)
+#define PBL_IF_RECT_ELSE(if_true, if_false) (if_true)
+#endif
+
+#define ARRAY_LENGTH(array) (sizeof(array) / sizeof((array)[0]))
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Logging
+//
+
+typedef enum {
+  APP_LOG_LEVEL_ERROR = 1,
+  APP_LOG_LEVEL_WARNING = 50,
+  APP_LOG_LEVEL_INFO = 100,
+  APP_LOG_LEVEL_DEBUG = 200,
+  APP_LOG_LEVEL_DEBUG_VERBOSE = 255,
+} AppLogLevel;
+
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number, const char *fmt,
+             ...) __attribute__((format(printf, 4, 5)));
+#define APP_LOG(level, fmt, args...) app_log(level, __FILE__, __LINE__, fmt, ##args)
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Time
+//
+
+#define SECONDS_PER_MINUTE 60
+#define SECONDS_PER_HOUR 3600
+
+//! The SDK's time() reads the virtual clock on the host
+time_t host_time(time_t *tloc);
+#define time(tloc) host_time(tloc)
+
+uint16_t time_ms(time_t *tloc, uint16_t *out_ms);
+bool clock_is_24h_style(void);
+void psleep(int millis);
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Math
+//
+
+#define TRIG_MAX_RATIO 0xffff
+#define TRIG_MAX_ANGLE 0x10000
+#define DEG_TO_TRIGANGLE(angle) (((angle) * TRIG_MAX_ANGLE) / 360)
+#define TRIGANGLE_TO_DEG(trig_angle) (((trig_angle) * 360) / TRIG_MAX_ANGLE)
+
+int32_t sin_lookup(int32_t angle);
+int32_t cos_lookup(int32_t angle);
+int32_t atan2_lookup(int16_t y, int16_t x);
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Memory and Storage
+//
+
+typedef int32_t status_t;
+#define S_SUCCESS 0
+#define E_ERROR -1
+#define E_INVALID_ARGUMENT -2
+#define E_OUT_OF_MEMORY -3
+#define E_OUT_OF_STORAGE -4
+#define E_OUT_OF_RESOURCES -5
+#define E_RANGE -6
+#define E_DOES_NOT_EXIST -7
+#define PERSIST_DATA_MAX_LENGTH 256
+
+size_t heap_bytes_free(void);
+size_t heap_bytes_used(void);
+
+bool persist_exists(uint32_t key);
+int persist_get_size(uint32_t key);
+int32_t persist_read_int(uint32_t key);
+int persist_read_data(uint32_t key, void *buffer, size_t buffer_size);
+status_t persist_write_int(uint32_t key, int32_t value);
+int persist_write_data(uint32_t key, const void *data, size_t size);
+status_t persist_delete(uint32_t key);
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Graphics Types
+//
+
+typedef struct GPoint {
+  int16_t x;
+  int16_t y;
+} GPoint;
+#define GPoint(x, y) ((GPoint){(x), (y)})
+#define GPointZero GPoint(0, 0)
+
+typedef struct GSize {
+  int16_t w;
+  int16_t h;
+} GSize;
+#define GSize(w, h) ((GSize){(w), (h)})
+#define GSizeZero GSize(0, 0)
+
+typedef struct GRect {
+  GPoint origin;
+  GSize size;
+} GRect;
+#define GRect(x, y, w, h) ((GRect){{(x), (y)}, {(w), (h)}})
+#define GRectZero GRect(0, 0, 0, 0)
+
+typedef struct GEdgeInsets {
+  int16_t top;
+  int16_t right;
+  int16_t bottom;
+  int16_t left;
+} GEdgeInsets;
+#define GEdgeInsets1(t) ((GEdgeInsets){(t), (t), (t), (t)})
+#define GEdgeInsets2(t, r) ((GEdgeInsets){(t), (r), (t), (r)})
+#define GEdgeInsets4(t, r, b, l) ((GEdgeInsets){(t), (r), (b), (l)})
+
+bool gpoint_equal(const GPoint *const point_a, const GPoint *const point_b);
+bool gsize_equal(const GSize *size_a, const GSize *size_b);
+bool grect_equal(const GRect *const rect_a, const GRect *const rect_b);
+GPoint grect_center_point(const GRect *rect);
+GRect grect_inset(GRect rect, GEdgeInsets insets);
+
+typedef union GColor8 {
+  uint8_t argb;
+  struct {
+    uint8_t b : 2;
+    uint8_t g : 2;
+    uint8_t r : 2;
+    uint8_t a : 2;
+  };
+} GColor8;
+typedef GColor8 GColor;
+
+#define GColorFromHEX(hex)                                                                         \
+  ((GColor8){.argb = 0xC0 | ((((hex) >> 22) & 0x3) << 4) | ((((hex) >> 14) & 0x3) << 2) |        \
+                     (((hex) >> 6) & 0x3)})
+#define GColorClear ((GColor8){.argb = 0x00})
+#define GColorBlack ((GColor8){.argb = 0xC0})
+#define GColorDarkGray ((GColor8){.argb = 0xD5})
+#define GColorLightGray ((GColor8){.argb = 0xEA})
+#define GColorWhite ((GColor8){.argb = 0xFF})
+#define GColorGreen ((GColor8){.argb = 0xCC})
+#define GColorMintGreen ((GColor8){.argb = 0xEE})
+#define GColorRed ((GColor8){.argb = 0xF0})
+#define GColorBlue ((GColor8){.argb = 0xC3})
+
+bool gcolor_equal(GColor8 color_a, GColor8 color_b);
+
+typedef enum {
+  GCornerNone = 0,
+  GCornerTopLeft = 1 << 0,
+  GCornerTopRight = 1 << 1,
+  GCornerBottomLeft = 1 << 2,
+  GCornerBottomRight = 1 << 3,
+  GCornersAll = 0xF,
+  GCornersTop = GCornerTopLeft | GCornerTopRight,
+  GCornersBottom = GCornerBottomLeft | GCornerBottomRight,
+  GCornersLeft = GCornerTopLeft | GCornerBottomLeft,
+  GCornersRight = GCornerTopRight | GCornerBottomRight,
+} GCornerMask;
+
+typedef enum {
+  GCompOpAssign,
+  GCompOpAssignInverted,
+  GCompOpOr,
+  GCompOpAnd,
+  GCompOpClear,
+  GCompOpSet,
+} GCompOp;
+
+typedef enum {
+  GOvalScaleModeFitCircle,
+  GOvalScaleModeFillCircle,
+} GOvalScaleMode;
+
+typedef enum {
+  GBitmapFormat1Bit = 0,
+  GBitmapFormat8Bit,
+  GBitmapFormat1BitPalette,
+  GBitmapFormat2BitPalette,
+  GBitmapFormat4BitPalette,
+  GBitmapFormat8BitCircular,
+} GBitmapFormat;
+
+typedef struct {
+  uint8_t *data; //< Address of the byte at column 0 of the row
+  int16_t min_x; //< First column of the row which holds pixel data
+  int16_t max_x; //< Last column of the row which holds pixel data
+} GBitmapDataRowInfo;
+
+typedef struct GContext GContext;
+typedef struct GBitmap GBitmap;
+typedef struct GPath GPath;
+typedef struct HostFont *GFont;
+
+typedef struct GPathInfo {
+  uint32_t num_points;
+  GPoint *points;
+} GPathInfo;
+
+typedef enum {
+  GTextOverflowModeWordWrap,
+  GTextOverflowModeTrailingEllipsis,
+  GTextOverflowModeFill,
+} GTextOverflowMode;
+
+typedef enum {
+  GTextAlignmentLeft,
+  GTextAlignmentCenter,
+  GTextAlignmentRight,
+} GTextAlignment;
+
+typedef struct GTextAttributes GTextAttributes;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Graphics
+//
+
+void graphics_context_set_fill_color(GContext *ctx, GColor color);
+void graphics_context_set_stroke_color(GContext *ctx, GColor color);
+void graphics_context_set_text_color(GContext *ctx, GColor color);
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode);
+void graphics_context_set_antialiased(GContext *ctx, bool enable);
+void graphics_context_set_stroke_width(GContext *ctx, uint8_t stroke_width);
+
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask);
+void graphics_fill_circle(GContext *ctx, GPoint p, uint16_t radius);
+void graphics_fill_radial(GContext *ctx, GRect rect, GOvalScaleMode scale_mode,
+                          uint16_t inset_thickness, int32_t angle_start, int32_t angle_end);
+void graphics_draw_line(GContext *ctx, GPoint p0, GPoint p1);
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect);
+void graphics_draw_text(GContext *ctx, const char *text, GFont const font, const GRect box,
+                        const GTextOverflowMode overflow_mode, const GTextAlignment alignment,
+                        GTextAttributes *text_attributes);
+
+GBitmap *graphics_capture_frame_buffer(GContext *ctx);
+GBitmap *graphics_capture_frame_buffer_format(GContext *ctx, GBitmapFormat format);
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *buffer);
+
+GPath *gpath_create(const GPathInfo *init);
+void gpath_destroy(GPath *gpath);
+void gpath_draw_filled(GContext *ctx, GPath *path);
+void gpath_draw_outline(GContext *ctx, GPath *path);
+void gpath_rotate_to(GPath *path, int32_t angle);
+void gpath_move_to(GPath *path, GPoint point);
+
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format);
+GBitmap *gbitmap_create_blank_with_palette(GSize size, GBitmapFormat format, GColor *palette,
+                                           bool free_on_destroy);
+void gbitmap_destroy(GBitmap *bitmap);
+uint8_t *gbitmap_get_data(const GBitmap *bitmap);
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap);
+GRect gbitmap_get_bounds(const GBitmap *bitmap);
+GBitmapFormat gbitmap_get_format(const GBitmap *bitmap);
+GColor *gbitmap_get_palette(const GBitmap *bitmap);
+GBitmapDataRowInfo gbitmap_get_data_row_info(const GBitmap *bitmap, uint16_t y);
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Fonts and Resources
+//
+
+typedef uint32_t ResHandle;
+#define RESOURCE_ID_BEBAS_FONT_35 1
+#define FONT_KEY_GOTHIC_24_BOLD "RESOURCE_ID_GOTHIC_24_BOLD"
+#define FONT_KEY_GOTHIC_28_BOLD "RESOURCE_ID_GOTHIC_28_BOLD"
+
+ResHandle resource_get_handle(uint32_t resource_id);
+GFont fonts_get_system_font(const char *font_key);
+GFont fonts_load_custom_font(ResHandle handle);
+void fonts_unload_custom_font(GFont font);
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Windows and Layers
+//
+
+typedef struct Layer Layer;
+typedef struct Window Window;
+typedef void (*LayerUpdateProc)(Layer *layer, GContext *ctx);
+
+Layer *layer_create(GRect frame);
+void layer_destroy(Layer *layer);
+GRect layer_get_bounds(const Layer *layer);
+GRect layer_get_frame(const Layer *layer);
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc);
+void layer_mark_dirty(Layer *layer);
+void layer_add_child(Layer *parent, Layer *child);
+
+Window *window_create(void);
+void window_destroy(Window *window);
+Layer *window_get_root_layer(const Window *window);
+void window_set_background_color(Window *window, GColor background_color);
+void window_stack_push(Window *window, bool animated);
+Window *window_stack_pop(bool animated);
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Clicks
+//
+
+typedef enum {
+  BUTTON_ID_BACK = 0,
+  BUTTON_ID_UP,
+  BUTTON_ID_SELECT,
+  BUTTON_ID_DOWN,
+  NUM_BUTTONS
+} ButtonId;
+
+typedef struct HostClickRecognizer *ClickRecognizerRef;
+typedef void (*ClickHandler)(ClickRecognizerRef recognizer, void *context);
+typedef void (*ClickConfigProvider)(void *context);
+
+void window_set_click_config_provider(Window *window, ClickConfigProvider click_config_provider);
+void window_single_click_subscribe(ButtonId button_id, ClickHandler handler);
+void window_single_repeating_click_subscribe(ButtonId button_id, uint16_t repeat_interval_ms,
+                                             ClickHandler handler);
+void window_long_click_subscribe(ButtonId button_id, uint16_t delay_ms, ClickHandler down_handler,
+                                 ClickHandler up_handler);
+void window_raw_click_subscribe(ButtonId button_id, ClickHandler down_handler,
+                                ClickHandler up_handler, void *context);
+bool click_recognizer_is_repeating(ClickRecognizerRef recognizer);
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Services
+//
+
+typedef struct AppTimer AppTimer;
+typedef void (*AppTimerCallback)(void *data);
+
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data);
+bool app_timer_reschedule(AppTimer *timer_handle, uint32_t new_timeout_ms);
+void app_timer_cancel(AppTimer *timer_handle);
+
+typedef void (*AppFocusHandler)(bool in_focus);
+typedef struct {
+  AppFocusHandler will_focus;
+  AppFocusHandler did_focus;
+} AppFocusHandlers;
+
+void app_focus_service_subscribe_handlers(AppFocusHandlers handlers);
+void app_focus_service_unsubscribe(void);
+
+typedef struct {
+  const uint32_t *durations;
+  uint32_t num_segments;
+} VibePattern;
+
+void vibes_enqueue_custom_pattern(VibePattern pattern);
+void vibes_short_pulse(void);
+void vibes_long_pulse(void);
+void vibes_cancel(void);
+
+typedef int32_t WakeupId;
+WakeupId wakeup_schedule(time_t timestamp, int32_t cookie, bool notify_if_missed);
+void wakeup_cancel(WakeupId wakeup_id);
+void wakeup_cancel_all(void);
+bool wakeup_query(WakeupId wakeup_id, time_t *timestamp);
+
+typedef enum {
+  APP_LAUNCH_SYSTEM,
+  APP_LAUNCH_USER,
+  APP_LAUNCH_PHONE,
+  APP_LAUNCH_WAKEUP,
+  APP_LAUNCH_WORKER,
+  APP_LAUNCH_QUICK_LAUNCH,
+  APP_LAUNCH_TIMELINE_ACTION,
+  APP_LAUNCH_SMARTSTRAP,
+} AppLaunchReason;
+
+AppLaunchReason launch_reason(void);
+void app_event_loop(void);
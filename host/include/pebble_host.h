@@ -0,0 +1,169 @@
+//! @file pebble_host.h
+//! @brief Controls for driving the app on the host build
+//!
+//! The host stand-in for the SDK runs on a virtual clock, which only moves
+//! when a driver advances it. Advancing the clock fires every AppTimer which
+//! falls due, in deadline order, and renders a frame whenever a layer was
+//! marked dirty, as the event loop does on the watch. Drivers also inject
+//! clicks and focus changes, and read back what the app did: frames drawn,
+//! vibes, wakeups, allocations and the persist store.
+//!
+//! Drawing is rasterized into a framebuffer of the platform's size and
+//! format, 1 bit on B/W platforms and 8 bit elsewhere, with only the visible
+//! columns of each row on round platforms. Every primitive counts the pixels
+//! it writes and the time it takes, and frames can be compared and saved.
+//!
+//! @author agent
+//! @date October 16, 2026
+
+#pragma once
+#include <pebble.h>
+
+//! What the app did since the counters were last reset
+typedef struct {
+  uint32_t frames;          //< Frames rendered
+  uint32_t timers_fired;    //< AppTimer callbacks raised
+  uint32_t vibes;           //< Vibe patterns started
+  uint32_t wakeups;         //< Wakeups scheduled
+  uint32_t allocations;     //< Heap allocations made by the app
+  uint32_t frees;           //< Heap allocations freed by the app
+  size_t heap_high_water;   //< Most heap bytes in use at once
+  uint32_t persist_writes;  //< Persist records written or deleted
+} HostStats;
+
+//! Drawing primitives which are counted
+typedef enum {
+  HostPrimitiveFillRect,    //< graphics_fill_rect
+  HostPrimitiveFillCircle,  //< graphics_fill_circle
+  HostPrimitiveFillRadial,  //< graphics_fill_radial
+  HostPrimitivePathFilled,  //< gpath_draw_filled
+  HostPrimitivePathOutline, //< gpath_draw_outline
+  HostPrimitiveLine,        //< graphics_draw_line
+  HostPrimitiveBitmap,      //< graphics_draw_bitmap_in_rect
+  HostPrimitiveText,        //< graphics_draw_text, which draws nothing as fonts have no glyphs
+  HostPrimitiveFrameBuffer, //< Direct framebuffer access, counting the pixels it changed
+  HostPrimitiveCount,
+} HostPrimitive;
+
+//! What a drawing primitive cost since the counters were last reset
+typedef struct {
+  uint32_t calls;  //< Times it was called
+  uint64_t pixels; //< Pixels it wrote, including pixels written again
+  uint64_t ns;     //< Real time it took in nanoseconds
+} HostPrimitiveStats;
+
+//! Kinds of clicks which can be injected
+typedef enum {
+  HostClickSingle, //< Press and release
+  HostClickLong,   //< Press, hold past the long click delay, then release
+} HostClick;
+
+//! The event loop driver, run by app_event_loop until the app should exit
+typedef void (*HostEventLoop)(void);
+
+//! Reset the SDK state to a fresh watch: empty persist store, no wakeups, and zeroed counters
+//! @param epoch_ms The wall clock time to start the virtual clock at, in milliseconds
+void host_reset(uint64_t epoch_ms);
+
+//! Set how the next launch of the app starts
+//! @param reason The launch reason reported to the app
+//! @param event_loop The driver run by app_event_loop, which returns when the app should exit
+void host_launch(AppLaunchReason reason, HostEventLoop event_loop);
+
+//! Get the virtual clock time
+//! @return The virtual epoch in milliseconds
+uint64_t host_clock_now(void);
+
+//! Advance the virtual clock, firing every AppTimer which falls due along the way in deadline
+//! order and rendering after each one that dirtied a layer
+//! @param duration_ms How many milliseconds to advance the clock by
+void host_run(uint64_t duration_ms);
+
+//! Render a frame if any layer is dirty, as the event loop does after each event
+void host_render(void);
+
+//! Check if the app still has a window on the stack, which it needs to keep running
+//! @return True if any window is on the stack
+bool host_app_is_running(void);
+
+//! Inject a click on a button of the top window, then render
+//! @param button The button which is clicked
+//! @param click The kind of click
+void host_click(ButtonId button, HostClick click);
+
+//! Inject a held button which repeats, as a single click and then repeats, rendering after each
+//! @param button The button which is held
+//! @param count The number of clicks including the first
+void host_click_repeat(ButtonId button, uint16_t count);
+
+//! Inject the app losing or regaining focus, such as a notification covering it
+//! @param in_focus If the app now has focus
+void host_focus(bool in_focus);
+
+//! Get the earliest scheduled wakeup
+//! @param timestamp A pointer to where to store the wakeup time in seconds
+//! @return True if a wakeup is scheduled
+bool host_wakeup_next(time_t *timestamp);
+
+//! Save the state which outlives a launch of the app: the clock, counters, persist store and
+//! wakeups. Each launch runs in its own process, so the app's static data starts fresh as it does
+//! on the watch, and the state is passed between them through a file
+//! @param path The file to save to
+//! @return True if it was saved
+bool host_state_save(const char *path);
+
+//! Load the state saved by host_state_save
+//! @param path The file to load from
+//! @return True if it was loaded
+bool host_state_load(const char *path);
+
+//! Get the counters of what the app did
+//! @return The counters since the last reset
+const HostStats *host_get_stats(void);
+
+//! Set the handler for log lines, in place of printing them
+//! @param handler The function called with each formatted message, or NULL to print them
+void host_set_log_handler(void (*handler)(uint8_t level, const char *message));
+
+//! Set a handler called after every frame is rendered, which may render again with host_redraw
+//! @param handler The function called after each frame, or NULL for none
+void host_set_frame_handler(void (*handler)(void));
+
+//! Mark every layer dirty and render a frame, without calling the frame handler
+void host_redraw(void);
+
+//! Get the counters of each drawing primitive
+//! @return The counters, indexed by HostPrimitive
+const HostPrimitiveStats *host_graphics_get_stats(void);
+
+//! Get the name of a drawing primitive
+//! @param primitive The primitive
+//! @return Its name, such as "fill_rect"
+const char *host_graphics_primitive_name(HostPrimitive primitive);
+
+//! Get the size of the framebuffer's pixel data
+//! @return The size in bytes
+size_t host_frame_buffer_size(void);
+
+//! Copy out the framebuffer's pixel data
+//! @param data Where to copy host_frame_buffer_size bytes to
+void host_frame_buffer_copy(uint8_t *data);
+
+//! Invert every visible pixel of the framebuffer, so any pixel a frame doesn't draw stands out
+void host_frame_buffer_invert(void);
+
+//! Count the visible pixels which differ between two copies of the framebuffer
+//! @param data_a The first copy
+//! @param data_b The second copy
+//! @return The number of pixels which differ
+uint32_t host_frame_buffer_diff(const uint8_t *data_a, const uint8_t *data_b);
+
+//! Save a copy of the framebuffer as a PNG image
+//! @param path The file to write
+//! @param data The copy to save, or NULL for the framebuffer itself
+//! @return True if it was written
+bool host_frame_buffer_write_png(const char *path, const uint8_t *data);
+
+//! Get a monotonic real time, for timing work on the host rather than on the virtual clock
+//! @return The real time in nanoseconds
+uint64_t host_time_ns(void);
@@ -0,0 +1,860 @@
+// @file graphics.c
+// @brief Host stand-in for the Pebble SDK graphics
+//
+// Rasterizes the drawing primitives into a framebuffer of the platform's size
+// and format: 1 bit with the leftmost pixel in the least significant bit on
+// B/W platforms, 8 bit ARGB on color platforms, and only the visible columns
+// of each row on round platforms. Shapes are sampled at pixel centers, and
+// circles blend their edge by coverage when anti-aliased on color platforms.
+// Text draws nothing, since the fonts have no glyphs. Every primitive counts
+// the pixels it writes and the real time it takes.
+//
+// @author agent
+// @date October 16, 2026
+
+#include "host_internal.h"
+#include <math.h>
+
+#ifdef PBL_BW
+#define FRAME_BUFFER_FORMAT GBitmapFormat1Bit
+#define FRAME_BUFFER_ROW_BYTES ((PBL_DISPLAY_WIDTH + 31) / 32 * 4)
+#elif defined(PBL_ROUND)
+#define FRAME_BUFFER_FORMAT GBitmapFormat8BitCircular
+#define FRAME_BUFFER_ROW_BYTES PBL_DISPLAY_WIDTH
+#else
+#define FRAME_BUFFER_FORMAT GBitmapFormat8Bit
+#define FRAME_BUFFER_ROW_BYTES PBL_DISPLAY_WIDTH
+#endif
+#define FRAME_BUFFER_SIZE (FRAME_BUFFER_ROW_BYTES * PBL_DISPLAY_HEIGHT)
+#define COLOR_CHANNEL_MAX 3  //< Largest value of a 2 bit color channel
+#define COVERAGE_MAX 255     //< Coverage of a pixel which is entirely inside a shape
+
+// Drawing context
+struct GContext {
+  GColor fill_color;   //< Color of filled primitives
+  GColor stroke_color; //< Color of outlines
+  GColor text_color;   //< Color of text
+  GCompOp comp_op;     //< Compositing mode of bitmaps
+  bool antialiased;    //< If edges are anti-aliased
+  uint8_t stroke_width; //< Width of outlines
+  GPoint origin;       //< Framebuffer position of the layer being drawn
+};
+
+// Bitmap
+struct GBitmap {
+  uint8_t *data;          //< Pixel data
+  uint16_t bytes_per_row; //< Bytes in each row of pixel data
+  GRect bounds;           //< Bounds of the bitmap
+  GBitmapFormat format;   //< Format of the pixel data
+  GColor *palette;        //< Palette of palettized formats
+  bool free_palette;      //< If the palette is freed with the bitmap
+};
+
+// Path
+struct GPath {
+  uint32_t num_points; //< Number of points
+  GPoint *points;      //< Points of the path, owned by the app
+  int32_t rotation;    //< Rotation about the origin
+  GPoint offset;       //< Offset after rotating
+};
+
+// Font
+struct HostFont {
+  const char *name; //< Name the font was loaded by
+};
+
+// Main data
+static struct {
+  GContext ctx;                 //< The drawing context of the display
+  struct HostFont custom_font;  //< The one custom font resource
+  struct HostFont system_fonts[4]; //< System fonts handed out so far
+  bool initialized;             //< If the framebuffer has been set up
+  GBitmap frame_buffer;         //< The framebuffer, as handed out when captured
+  uint8_t data[FRAME_BUFFER_SIZE];          //< Pixel data of the framebuffer
+  uint8_t captured_data[FRAME_BUFFER_SIZE]; //< Pixel data when the framebuffer was captured
+  bool captured;                            //< If the framebuffer is captured
+  uint64_t captured_time;                   //< Real time the framebuffer was captured at
+  int16_t min_x[PBL_DISPLAY_HEIGHT];        //< First visible column of each row
+  int16_t max_x[PBL_DISPLAY_HEIGHT];        //< Last visible column of each row
+  HostPrimitive primitive;                  //< Primitive being drawn
+  HostPrimitiveStats stats[HostPrimitiveCount]; //< Counters of each primitive
+} graphics_data;
+
+// Names of the drawing primitives
+static const char *primitive_names[HostPrimitiveCount] = {
+    "fill_rect", "fill_circle", "fill_radial", "path_filled", "path_outline",
+    "line",      "bitmap",      "text",        "frame_buffer",
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Geometry and Color
+//
+
+// Check if two points are equal
+bool gpoint_equal(const GPoint *const point_a, const GPoint *const point_b) {
+  return point_a->x == point_b->x && point_a->y == point_b->y;
+}
+
+// Check if two sizes are equal
+bool gsize_equal(const GSize *size_a, const GSize *size_b) {
+  return size_a->w == size_b->w && size_a->h == size_b->h;
+}
+
+// Check if two rectangles are equal
+bool grect_equal(const GRect *const rect_a, const GRect *const rect_b) {
+  return gpoint_equal(&rect_a->origin, &rect_b->origin) && gsize_equal(&rect_a->size, &rect_b->size);
+}
+
+// Get the center of a rectangle
+GPoint grect_center_point(const GRect *rect) {
+  return GPoint(rect->origin.x + rect->size.w / 2, rect->origin.y + rect->size.h / 2);
+}
+
+// Inset a rectangle, which is empty if the insets are larger than it
+GRect grect_inset(GRect rect, GEdgeInsets insets) {
+  GRect inset = GRect(rect.origin.x + insets.left, rect.origin.y + insets.top,
+                      rect.size.w - insets.left - insets.right,
+                      rect.size.h - insets.top - insets.bottom);
+  return inset.size.w < 0 || inset.size.h < 0 ? GRectZero : inset;
+}
+
+// Check if two colors are equal
+bool gcolor_equal(GColor8 color_a, GColor8 color_b) { return color_a.argb == color_b.argb; }
+
+#ifdef PBL_BW
+// Check if a color shows as white on a 1 bit display, where light grey and lighter are white
+static bool prv_color_is_white(GColor color) { return color.r + color.g + color.b >= 6; }
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Framebuffer
+//
+
+// Set up the framebuffer, cleared to black, along with the visible columns of each row
+static void prv_frame_buffer_initialize(void) {
+  graphics_data.frame_buffer = (GBitmap){
+      .data = graphics_data.data,
+      .bytes_per_row = FRAME_BUFFER_ROW_BYTES,
+      .bounds = GRect(0, 0, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT),
+      .format = FRAME_BUFFER_FORMAT,
+  };
+  memset(graphics_data.data, PBL_IF_COLOR_ELSE(GColorBlack.argb, 0), FRAME_BUFFER_SIZE);
+  for (int16_t y = 0; y < PBL_DISPLAY_HEIGHT; y++) {
+#ifdef PBL_ROUND
+    // the display is a circle as wide as it is, cut at pixel centers
+    double radius = PBL_DISPLAY_WIDTH / 2.0;
+    double dy = y + 0.5 - PBL_DISPLAY_HEIGHT / 2.0;
+    double half_width = sqrt(radius * radius - dy * dy);
+    graphics_data.min_x[y] = (int16_t)lround(radius - half_width);
+    graphics_data.max_x[y] = PBL_DISPLAY_WIDTH - 1 - graphics_data.min_x[y];
+#else
+    graphics_data.min_x[y] = 0;
+    graphics_data.max_x[y] = PBL_DISPLAY_WIDTH - 1;
+#endif
+  }
+  graphics_data.initialized = true;
+}
+
+// Check if a framebuffer pixel is on the display
+static bool prv_pixel_visible(int32_t x, int32_t y) {
+  return y >= 0 && y < PBL_DISPLAY_HEIGHT && x >= graphics_data.min_x[y] &&
+         x <= graphics_data.max_x[y];
+}
+
+// Get the color of a framebuffer pixel
+static GColor prv_pixel_get(const uint8_t *data, int16_t x, int16_t y) {
+  const uint8_t *row = data + y * FRAME_BUFFER_ROW_BYTES;
+#ifdef PBL_BW
+  return row[x / 8] & (1 << (x % 8)) ? GColorWhite : GColorBlack;
+#else
+  return (GColor){.argb = row[x]};
+#endif
+}
+
+// Write an opaque color to a visible framebuffer pixel, counting it against the current primitive
+static void prv_pixel_put(int16_t x, int16_t y, GColor color) {
+  uint8_t *row = graphics_data.data + y * FRAME_BUFFER_ROW_BYTES;
+#ifdef PBL_BW
+  uint8_t mask = 1 << (x % 8);
+  row[x / 8] = prv_color_is_white(color) ? row[x / 8] | mask : row[x / 8] & ~mask;
+#else
+  row[x] = color.argb | GColorBlack.argb;
+#endif
+  graphics_data.stats[graphics_data.primitive].pixels++;
+}
+
+#ifdef PBL_COLOR
+// Blend a color channel by an alpha out of COVERAGE_MAX
+static uint8_t prv_channel_blend(uint8_t src, uint8_t dst, uint16_t alpha) {
+  return (src * alpha + dst * (COVERAGE_MAX - alpha) + COVERAGE_MAX / 2) / COVERAGE_MAX;
+}
+#endif
+
+// Blend a color over a framebuffer pixel by its alpha and the pixel's coverage, out of
+// COVERAGE_MAX. B/W has no blending, so a pixel is written if it is mostly covered
+static void prv_pixel_blend(int32_t x, int32_t y, GColor color, uint8_t coverage) {
+  uint16_t alpha = color.a * coverage / COLOR_CHANNEL_MAX;
+  if (!alpha || !prv_pixel_visible(x, y)) {
+    return;
+  }
+#ifdef PBL_BW
+  if (alpha > COVERAGE_MAX / 2) {
+    prv_pixel_put(x, y, color);
+  }
+#else
+  if (alpha < COVERAGE_MAX) {
+    GColor dst = prv_pixel_get(graphics_data.data, x, y);
+    color.r = prv_channel_blend(color.r, dst.r, alpha);
+    color.g = prv_channel_blend(color.g, dst.g, alpha);
+    color.b = prv_channel_blend(color.b, dst.b, alpha);
+  }
+  prv_pixel_put(x, y, color);
+#endif
+}
+
+// Fill columns [x_0, x_1) of a framebuffer row with a color, writing opaque colors a row at a time
+static void prv_span_fill(int32_t y, int32_t x_0, int32_t x_1, GColor color) {
+  if (y < 0 || y >= PBL_DISPLAY_HEIGHT) {
+    return;
+  }
+  x_0 = x_0 < graphics_data.min_x[y] ? graphics_data.min_x[y] : x_0;
+  x_1 = x_1 > graphics_data.max_x[y] + 1 ? graphics_data.max_x[y] + 1 : x_1;
+#ifdef PBL_COLOR
+  if (color.a == COLOR_CHANNEL_MAX && x_0 < x_1) {
+    memset(graphics_data.data + y * FRAME_BUFFER_ROW_BYTES + x_0, color.argb, x_1 - x_0);
+    graphics_data.stats[graphics_data.primitive].pixels += x_1 - x_0;
+    return;
+  }
+#endif
+  for (int32_t x = x_0; x < x_1; x++) {
+    prv_pixel_blend(x, y, color, COVERAGE_MAX);
+  }
+}
+
+// Start counting a primitive
+static uint64_t prv_primitive_begin(HostPrimitive primitive) {
+  graphics_data.primitive = primitive;
+  graphics_data.stats[primitive].calls++;
+  return host_time_ns();
+}
+
+// Stop timing the current primitive
+static void prv_primitive_end(uint64_t start_time) {
+  graphics_data.stats[graphics_data.primitive].ns += host_time_ns() - start_time;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Bitmaps
+//
+
+// Get the number of bits per pixel of a format
+static uint8_t prv_format_bits(GBitmapFormat format) {
+  switch (format) {
+  case GBitmapFormat1Bit:
+  case GBitmapFormat1BitPalette:
+    return 1;
+  case GBitmapFormat2BitPalette:
+    return 2;
+  case GBitmapFormat4BitPalette:
+    return 4;
+  default:
+    return 8;
+  }
+}
+
+// Create a blank bitmap with a palette
+GBitmap *gbitmap_create_blank_with_palette(GSize size, GBitmapFormat format, GColor *palette,
+                                           bool free_on_destroy) {
+  GBitmap *bitmap = host_malloc(sizeof(GBitmap));
+  if (!bitmap) {
+    return NULL;
+  }
+  uint8_t bits = prv_format_bits(format);
+  // 1 bit bitmaps are word aligned, like the watch, while the others are byte aligned
+  uint16_t bytes_per_row = format == GBitmapFormat1Bit ? (size.w + 31) / 32 * 4
+                                                        : (size.w * bits + 7) / 8;
+  (*bitmap) = (GBitmap){
+      .data = host_malloc(bytes_per_row * size.h),
+      .bytes_per_row = bytes_per_row,
+      .bounds = GRect(0, 0, size.w, size.h),
+      .format = format,
+      .palette = palette,
+      .free_palette = free_on_destroy,
+  };
+  if (!bitmap->data) {
+    host_free(bitmap);
+    return NULL;
+  }
+  memset(bitmap->data, 0, bytes_per_row * size.h);
+  return bitmap;
+}
+
+// Create a blank bitmap
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format) {
+  GColor *palette = NULL;
+  if (format == GBitmapFormat1BitPalette || format == GBitmapFormat2BitPalette ||
+      format == GBitmapFormat4BitPalette) {
+    palette = host_malloc(sizeof(GColor) << prv_format_bits(format));
+    if (!palette) {
+      return NULL;
+    }
+    memset(palette, 0, sizeof(GColor) << prv_format_bits(format));
+  }
+  return gbitmap_create_blank_with_palette(size, format, palette, palette != NULL);
+}
+
+// Destroy a bitmap
+void gbitmap_destroy(GBitmap *bitmap) {
+  if (!bitmap) {
+    return;
+  }
+  if (bitmap->free_palette) {
+    host_free(bitmap->palette);
+  }
+  host_free(bitmap->data);
+  host_free(bitmap);
+}
+
+// Get the pixel data of a bitmap
+uint8_t *gbitmap_get_data(const GBitmap *bitmap) { return bitmap->data; }
+
+// Get the bytes in each row of a bitmap
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap) { return bitmap->bytes_per_row; }
+
+// Get the bounds of a bitmap
+GRect gbitmap_get_bounds(const GBitmap *bitmap) { return bitmap->bounds; }
+
+// Get the format of a bitmap
+GBitmapFormat gbitmap_get_format(const GBitmap *bitmap) { return bitmap->format; }
+
+// Get the palette of a bitmap
+GColor *gbitmap_get_palette(const GBitmap *bitmap) { return bitmap->palette; }
+
+// Get the pixel data of a row of a bitmap, which only covers the visible columns of a circular
+// framebuffer
+GBitmapDataRowInfo gbitmap_get_data_row_info(const GBitmap *bitmap, uint16_t y) {
+  bool circular = bitmap->format == GBitmapFormat8BitCircular && y < PBL_DISPLAY_HEIGHT;
+  return (GBitmapDataRowInfo){
+      .data = bitmap->data + y * bitmap->bytes_per_row,
+      .min_x = circular ? graphics_data.min_x[y] : 0,
+      .max_x = circular ? graphics_data.max_x[y] : bitmap->bounds.size.w - 1,
+  };
+}
+
+// Get a pixel of a bitmap, along with its bit in 1 bit formats, where a set bit is white
+static GColor prv_bitmap_pixel_get(const GBitmap *bitmap, int16_t x, int16_t y, bool *bit) {
+  const uint8_t *row = bitmap->data + y * bitmap->bytes_per_row;
+  uint8_t bits = prv_format_bits(bitmap->format);
+  if (bitmap->format == GBitmapFormat1Bit) {
+    // the leftmost pixel is the least significant bit
+    (*bit) = row[x / 8] & (1 << (x % 8));
+    return (*bit) ? GColorWhite : GColorBlack;
+  } else if (bits < 8) {
+    // palettized formats put the leftmost pixel in the most significant bits
+    uint8_t shift = 8 - bits - (x * bits) % 8;
+    uint8_t index = (row[x * bits / 8] >> shift) & ((1 << bits) - 1);
+    (*bit) = index;
+    return bitmap->palette[index];
+  }
+  (*bit) = false;
+  return (GColor){.argb = row[x]};
+}
+
+// Composite a bitmap pixel onto a framebuffer pixel. 1 bit bitmaps combine their bits with the
+// framebuffer's, while other formats assign their color or blend it with GCompOpSet
+static void prv_bitmap_pixel_composite(int32_t x, int32_t y, GCompOp comp_op, GColor color,
+                                       bool bit, bool one_bit) {
+  if (!prv_pixel_visible(x, y)) {
+    return;
+  }
+  if (!one_bit) {
+    if (comp_op == GCompOpSet) {
+      prv_pixel_blend(x, y, color, COVERAGE_MAX);
+    } else {
+      prv_pixel_put(x, y, color);
+    }
+    return;
+  }
+  switch (comp_op) {
+  case GCompOpAssign:
+    prv_pixel_put(x, y, bit ? GColorWhite : GColorBlack);
+    break;
+  case GCompOpAssignInverted:
+    prv_pixel_put(x, y, bit ? GColorBlack : GColorWhite);
+    break;
+  case GCompOpOr:
+    if (bit) {
+      prv_pixel_put(x, y, GColorWhite);
+    }
+    break;
+  case GCompOpAnd:
+    if (!bit) {
+      prv_pixel_put(x, y, GColorBlack);
+    }
+    break;
+  case GCompOpClear:
+    if (bit) {
+      prv_pixel_put(x, y, GColorBlack);
+    }
+    break;
+  case GCompOpSet:
+    if (!bit) {
+      prv_pixel_put(x, y, GColorWhite);
+    }
+    break;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Paths
+//
+
+// Create a path, which keeps pointing at the app's points
+GPath *gpath_create(const GPathInfo *init) {
+  GPath *path = host_malloc(sizeof(GPath));
+  if (path) {
+    (*path) = (GPath){.num_points = init->num_points, .points = init->points};
+  }
+  return path;
+}
+
+// Destroy a path
+void gpath_destroy(GPath *gpath) { host_free(gpath); }
+
+// Rotate a path about its origin
+void gpath_rotate_to(GPath *path, int32_t angle) { path->rotation = angle; }
+
+// Move a path
+void gpath_move_to(GPath *path, GPoint point) { path->offset = point; }
+
+// Get a point of a path rotated, moved and in framebuffer coordinates
+static GPoint prv_path_point(const GPath *path, uint32_t index, GPoint origin) {
+  GPoint point = path->points[index % path->num_points];
+  int32_t sin = sin_lookup(path->rotation);
+  int32_t cos = cos_lookup(path->rotation);
+  int32_t x = (point.x * cos - point.y * sin) / TRIG_MAX_RATIO;
+  int32_t y = (point.x * sin + point.y * cos) / TRIG_MAX_RATIO;
+  return GPoint(x + path->offset.x + origin.x, y + path->offset.y + origin.y);
+}
+
+// Sort the columns where a row crosses the edges of a path
+static void prv_crossings_sort(double *crossings, uint32_t count) {
+  for (uint32_t ii = 1; ii < count; ii++) {
+    for (uint32_t jj = ii; jj > 0 && crossings[jj - 1] > crossings[jj]; jj--) {
+      double crossing = crossings[jj];
+      crossings[jj] = crossings[jj - 1];
+      crossings[jj - 1] = crossing;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Drawing
+//
+
+// Set the fill color
+void graphics_context_set_fill_color(GContext *ctx, GColor color) { ctx->fill_color = color; }
+
+// Set the stroke color
+void graphics_context_set_stroke_color(GContext *ctx, GColor color) { ctx->stroke_color = color; }
+
+// Set the text color
+void graphics_context_set_text_color(GContext *ctx, GColor color) { ctx->text_color = color; }
+
+// Set the compositing mode of bitmaps
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode) { ctx->comp_op = mode; }
+
+// Set if edges are anti-aliased
+void graphics_context_set_antialiased(GContext *ctx, bool enable) { ctx->antialiased = enable; }
+
+// Set the width of outlines
+void graphics_context_set_stroke_width(GContext *ctx, uint8_t stroke_width) {
+  ctx->stroke_width = stroke_width;
+}
+
+// Check if a pixel is cut off by a rounded corner of a rectangle
+static bool prv_rect_corner_cuts(GRect rect, uint16_t radius, GCornerMask mask, int32_t x,
+                                 int32_t y) {
+  // compare pixel centers with the centers of the corner circles
+  double px = x + 0.5;
+  double py = y + 0.5;
+  double left = rect.origin.x + radius;
+  double right = rect.origin.x + rect.size.w - radius;
+  double top = rect.origin.y + radius;
+  double bottom = rect.origin.y + rect.size.h - radius;
+  double cx;
+  double cy;
+  if (px < left && py < top && (mask & GCornerTopLeft)) {
+    cx = left, cy = top;
+  } else if (px > right && py < top && (mask & GCornerTopRight)) {
+    cx = right, cy = top;
+  } else if (px < left && py > bottom && (mask & GCornerBottomLeft)) {
+    cx = left, cy = bottom;
+  } else if (px > right && py > bottom && (mask & GCornerBottomRight)) {
+    cx = right, cy = bottom;
+  } else {
+    return false;
+  }
+  return (px - cx) * (px - cx) + (py - cy) * (py - cy) > (double)radius * radius;
+}
+
+// Fill a rectangle
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius,
+                        GCornerMask corner_mask) {
+  uint64_t start_time = prv_primitive_begin(HostPrimitiveFillRect);
+  if (rect.size.w < 0) {
+    rect.origin.x += rect.size.w;
+    rect.size.w = -rect.size.w;
+  }
+  if (rect.size.h < 0) {
+    rect.origin.y += rect.size.h;
+    rect.size.h = -rect.size.h;
+  }
+  rect.origin.x += ctx->origin.x;
+  rect.origin.y += ctx->origin.y;
+  for (int32_t y = rect.origin.y; y < rect.origin.y + rect.size.h; y++) {
+    if (!corner_radius) {
+      prv_span_fill(y, rect.origin.x, rect.origin.x + rect.size.w, ctx->fill_color);
+      continue;
+    }
+    for (int32_t x = rect.origin.x; x < rect.origin.x + rect.size.w; x++) {
+      if (!prv_rect_corner_cuts(rect, corner_radius, corner_mask, x, y)) {
+        prv_pixel_blend(x, y, ctx->fill_color, COVERAGE_MAX);
+      }
+    }
+  }
+  prv_primitive_end(start_time);
+}
+
+// Fill a circle centered on a pixel, blending its edge by coverage when anti-aliased
+void graphics_fill_circle(GContext *ctx, GPoint p, uint16_t radius) {
+  uint64_t start_time = prv_primitive_begin(HostPrimitiveFillCircle);
+  int32_t center_x = p.x + ctx->origin.x;
+  int32_t center_y = p.y + ctx->origin.y;
+  int32_t reach = radius + 1;
+  bool antialiased = PBL_IF_COLOR_ELSE(ctx->antialiased, false);
+  // without anti-aliasing a pixel is in if its center is within the radius, with it a pixel is
+  // entirely covered if it is within half a pixel less than the radius
+  int32_t inside_sq = antialiased ? (2 * radius - 1) * (2 * radius - 1) : 4 * radius * radius;
+  for (int32_t dy = -reach; dy <= reach; dy++) {
+    // the entirely covered pixels of the row are one span
+    int32_t half_width = -1;
+    while (4 * ((half_width + 1) * (half_width + 1) + dy * dy) <= inside_sq) {
+      half_width++;
+    }
+    prv_span_fill(center_y + dy, center_x - half_width, center_x + half_width + 1,
+                  ctx->fill_color);
+    // then blend the partly covered pixels on either side of it
+    for (int32_t dx = half_width + 1; antialiased && dx <= reach; dx++) {
+      double edge = radius + 0.5 - sqrt(dx * dx + dy * dy);
+      uint8_t coverage = edge <= 0.0 ? 0 : lround(edge * COVERAGE_MAX);
+      if (coverage && dx) {
+        prv_pixel_blend(center_x - dx, center_y + dy, ctx->fill_color, coverage);
+      }
+      if (coverage) {
+        prv_pixel_blend(center_x + dx, center_y + dy, ctx->fill_color, coverage);
+      }
+    }
+  }
+  prv_primitive_end(start_time);
+}
+
+// Fill the part of a ring between two angles, clockwise from the top
+void graphics_fill_radial(GContext *ctx, GRect rect, GOvalScaleMode scale_mode,
+                          uint16_t inset_thickness, int32_t angle_start, int32_t angle_end) {
+  uint64_t start_time = prv_primitive_begin(HostPrimitiveFillRadial);
+  double center_x = rect.origin.x + ctx->origin.x + rect.size.w / 2.0;
+  double center_y = rect.origin.y + ctx->origin.y + rect.size.h / 2.0;
+  bool wider = rect.size.w > rect.size.h;
+  int16_t diameter = (scale_mode == GOvalScaleModeFitCircle) == wider ? rect.size.h : rect.size.w;
+  double outer = diameter / 2.0;
+  double inner = outer > inset_thickness ? outer - inset_thickness : 0.0;
+  int32_t y_0 = floor(center_y - outer);
+  int32_t y_1 = ceil(center_y + outer);
+  int32_t x_0 = floor(center_x - outer);
+  int32_t x_1 = ceil(center_x + outer);
+  for (int32_t y = y_0; angle_end > angle_start && y < y_1; y++) {
+    double dy = y + 0.5 - center_y;
+    for (int32_t x = x_0; x < x_1; x++) {
+      double dx = x + 0.5 - center_x;
+      double distance_sq = dx * dx + dy * dy;
+      if (distance_sq >= outer * outer || distance_sq < inner * inner) {
+        continue;
+      }
+      int32_t angle = floor(atan2(dx, -dy) * TRIG_MAX_ANGLE / (2 * M_PI));
+      if (angle < 0) {
+        angle += TRIG_MAX_ANGLE;
+      }
+      // the angles may run past a full turn
+      if ((angle >= angle_start && angle < angle_end) ||
+          (angle + TRIG_MAX_ANGLE >= angle_start && angle + TRIG_MAX_ANGLE < angle_end)) {
+        prv_pixel_blend(x, y, ctx->fill_color, COVERAGE_MAX);
+      }
+    }
+  }
+  prv_primitive_end(start_time);
+}
+
+// Draw a line in framebuffer coordinates, as squares of the stroke width
+static void prv_line_draw(GContext *ctx, GPoint p0, GPoint p1) {
+  int32_t dx = abs(p1.x - p0.x);
+  int32_t dy = -abs(p1.y - p0.y);
+  int32_t step_x = p0.x < p1.x ? 1 : -1;
+  int32_t step_y = p0.y < p1.y ? 1 : -1;
+  int32_t error = dx + dy;
+  int32_t width = ctx->stroke_width ? ctx->stroke_width : 1;
+  int32_t x = p0.x;
+  int32_t y = p0.y;
+  while (true) {
+    for (int32_t brush_y = 0; brush_y < width; brush_y++) {
+      for (int32_t brush_x = 0; brush_x < width; brush_x++) {
+        prv_pixel_blend(x + brush_x - width / 2, y + brush_y - width / 2, ctx->stroke_color,
+                        COVERAGE_MAX);
+      }
+    }
+    if (x == p1.x && y == p1.y) {
+      break;
+    }
+    int32_t error_2 = error * 2;
+    if (error_2 >= dy) {
+      error += dy;
+      x += step_x;
+    }
+    if (error_2 <= dx) {
+      error += dx;
+      y += step_y;
+    }
+  }
+}
+
+// Draw a line
+void graphics_draw_line(GContext *ctx, GPoint p0, GPoint p1) {
+  uint64_t start_time = prv_primitive_begin(HostPrimitiveLine);
+  p0.x += ctx->origin.x;
+  p0.y += ctx->origin.y;
+  p1.x += ctx->origin.x;
+  p1.y += ctx->origin.y;
+  prv_line_draw(ctx, p0, p1);
+  prv_primitive_end(start_time);
+}
+
+// Draw a bitmap, tiling it from the rectangle's origin to fill the rectangle
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect) {
+  uint64_t start_time = prv_primitive_begin(HostPrimitiveBitmap);
+  GSize size = bitmap->bounds.size;
+  bool one_bit = bitmap->format == GBitmapFormat1Bit;
+  rect.origin.x += ctx->origin.x;
+  rect.origin.y += ctx->origin.y;
+  for (int16_t y = 0; size.w > 0 && size.h > 0 && y < rect.size.h; y++) {
+    for (int16_t x = 0; x < rect.size.w; x++) {
+      bool bit;
+      GColor color = prv_bitmap_pixel_get(bitmap, x % size.w, y % size.h, &bit);
+      prv_bitmap_pixel_composite(rect.origin.x + x, rect.origin.y + y, ctx->comp_op, color, bit,
+                                 one_bit);
+    }
+  }
+  prv_primitive_end(start_time);
+}
+
+// Draw text, which draws nothing since the fonts have no glyphs
+void graphics_draw_text(GContext *ctx, const char *text, GFont const font, const GRect box,
+                        const GTextOverflowMode overflow_mode, const GTextAlignment alignment,
+                        GTextAttributes *text_attributes) {
+  prv_primitive_end(prv_primitive_begin(HostPrimitiveText));
+}
+
+// Fill a path, covering the pixels whose centers are inside it by the even-odd rule
+void gpath_draw_filled(GContext *ctx, GPath *path) {
+  uint64_t start_time = prv_primitive_begin(HostPrimitivePathFilled);
+  double *crossings = path->num_points > 2 ? malloc(path->num_points * sizeof(double)) : NULL;
+  int32_t y_0 = INT16_MAX;
+  int32_t y_1 = INT16_MIN;
+  for (uint32_t ii = 0; crossings && ii < path->num_points; ii++) {
+    GPoint point = prv_path_point(path, ii, ctx->origin);
+    y_0 = point.y < y_0 ? point.y : y_0;
+    y_1 = point.y > y_1 ? point.y : y_1;
+  }
+  for (int32_t y = y_0; y < y_1; y++) {
+    double center_y = y + 0.5;
+    uint32_t count = 0;
+    for (uint32_t ii = 0; ii < path->num_points; ii++) {
+      GPoint point_a = prv_path_point(path, ii, ctx->origin);
+      GPoint point_b = prv_path_point(path, ii + 1, ctx->origin);
+      if ((point_a.y <= center_y) != (point_b.y <= center_y)) {
+        crossings[count++] = point_a.x + (center_y - point_a.y) * (point_b.x - point_a.x) /
+                                             (point_b.y - point_a.y);
+      }
+    }
+    prv_crossings_sort(crossings, count);
+    for (uint32_t ii = 0; ii + 1 < count; ii += 2) {
+      for (int32_t x = ceil(crossings[ii] - 0.5); x < ceil(crossings[ii + 1] - 0.5); x++) {
+        prv_pixel_blend(x, y, ctx->fill_color, COVERAGE_MAX);
+      }
+    }
+  }
+  free(crossings);
+  prv_primitive_end(start_time);
+}
+
+// Draw the outline of a path, closing it back to its first point
+void gpath_draw_outline(GContext *ctx, GPath *path) {
+  uint64_t start_time = prv_primitive_begin(HostPrimitivePathOutline);
+  for (uint32_t ii = 0; ii < path->num_points; ii++) {
+    prv_line_draw(ctx, prv_path_point(path, ii, ctx->origin),
+                  prv_path_point(path, ii + 1, ctx->origin));
+  }
+  prv_primitive_end(start_time);
+}
+
+// Capture the framebuffer, which is only handed out once at a time and in its own format
+GBitmap *graphics_capture_frame_buffer_format(GContext *ctx, GBitmapFormat format) {
+  if (graphics_data.captured || format != FRAME_BUFFER_FORMAT) {
+    return NULL;
+  }
+  graphics_data.captured = true;
+  graphics_data.captured_time = prv_primitive_begin(HostPrimitiveFrameBuffer);
+  // pixels written straight into the framebuffer are counted by comparing it on release
+  memcpy(graphics_data.captured_data, graphics_data.data, FRAME_BUFFER_SIZE);
+  return &graphics_data.frame_buffer;
+}
+
+// Capture the framebuffer
+GBitmap *graphics_capture_frame_buffer(GContext *ctx) {
+  return graphics_capture_frame_buffer_format(ctx, FRAME_BUFFER_FORMAT);
+}
+
+// Release the captured framebuffer, counting the pixels which changed while it was captured
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *buffer) {
+  if (!graphics_data.captured || buffer != &graphics_data.frame_buffer) {
+    return false;
+  }
+  graphics_data.captured = false;
+  graphics_data.primitive = HostPrimitiveFrameBuffer;
+  prv_primitive_end(graphics_data.captured_time);
+  graphics_data.stats[HostPrimitiveFrameBuffer].pixels +=
+      host_frame_buffer_diff(graphics_data.captured_data, graphics_data.data);
+  return true;
+}
+
+// Start drawing a frame
+GContext *host_graphics_frame_begin(GColor background) {
+  if (!graphics_data.initialized) {
+    prv_frame_buffer_initialize();
+  }
+  // the system fills the window background, which isn't counted against the app
+  uint64_t pixels = graphics_data.stats[graphics_data.primitive].pixels;
+  for (int16_t y = 0; background.a && y < PBL_DISPLAY_HEIGHT; y++) {
+    for (int16_t x = graphics_data.min_x[y]; x <= graphics_data.max_x[y]; x++) {
+      prv_pixel_put(x, y, background);
+    }
+  }
+  graphics_data.stats[graphics_data.primitive].pixels = pixels;
+  graphics_data.ctx = (GContext){
+      .fill_color = GColorBlack,
+      .stroke_color = GColorBlack,
+      .text_color = GColorBlack,
+      .antialiased = true,
+      .stroke_width = 1,
+  };
+  return &graphics_data.ctx;
+}
+
+// Move where a layer draws from
+void host_graphics_set_origin(GContext *ctx, GPoint origin) { ctx->origin = origin; }
+
+// Reset the graphics state
+void host_graphics_reset(void) { memset(&graphics_data, 0, sizeof(graphics_data)); }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Host Controls
+//
+
+// Get the counters of each drawing primitive
+const HostPrimitiveStats *host_graphics_get_stats(void) { return graphics_data.stats; }
+
+// Get the name of a drawing primitive
+const char *host_graphics_primitive_name(HostPrimitive primitive) {
+  return primitive < HostPrimitiveCount ? primitive_names[primitive] : "unknown";
+}
+
+// Get the size of the framebuffer's pixel data
+size_t host_frame_buffer_size(void) { return FRAME_BUFFER_SIZE; }
+
+// Copy out the framebuffer's pixel data
+void host_frame_buffer_copy(uint8_t *data) {
+  memcpy(data, graphics_data.data, FRAME_BUFFER_SIZE);
+}
+
+// Invert every visible pixel of the framebuffer
+void host_frame_buffer_invert(void) {
+  for (int16_t y = 0; graphics_data.initialized && y < PBL_DISPLAY_HEIGHT; y++) {
+    uint8_t *row = graphics_data.data + y * FRAME_BUFFER_ROW_BYTES;
+    for (int16_t x = graphics_data.min_x[y]; x <= graphics_data.max_x[y]; x++) {
+#ifdef PBL_BW
+      row[x / 8] ^= 1 << (x % 8);
+#else
+      row[x] ^= ~GColorBlack.argb;
+#endif
+    }
+  }
+}
+
+// Count the visible pixels which differ between two copies of the framebuffer
+uint32_t host_frame_buffer_diff(const uint8_t *data_a, const uint8_t *data_b) {
+  uint32_t count = 0;
+  for (int16_t y = 0; y < PBL_DISPLAY_HEIGHT; y++) {
+    size_t offset = y * FRAME_BUFFER_ROW_BYTES;
+    if (memcmp(data_a + offset, data_b + offset, FRAME_BUFFER_ROW_BYTES) == 0) {
+      continue;
+    }
+    for (int16_t x = graphics_data.min_x[y]; x <= graphics_data.max_x[y]; x++) {
+      count += !gcolor_equal(prv_pixel_get(data_a, x, y), prv_pixel_get(data_b, x, y));
+    }
+  }
+  return count;
+}
+
+// Save a copy of the framebuffer as a PNG image, with the pixels off the display in black
+bool host_frame_buffer_write_png(const char *path, const uint8_t *data) {
+  static uint8_t rgb[PBL_DISPLAY_WIDTH * PBL_DISPLAY_HEIGHT * 3];
+  data = data ? data : graphics_data.data;
+  memset(rgb, 0, sizeof(rgb));
+  for (int16_t y = 0; y < PBL_DISPLAY_HEIGHT; y++) {
+    for (int16_t x = graphics_data.min_x[y]; x <= graphics_data.max_x[y]; x++) {
+      GColor color = prv_pixel_get(data, x, y);
+      uint8_t *pixel = rgb + (y * PBL_DISPLAY_WIDTH + x) * 3;
+      pixel[0] = color.r * 0x55;
+      pixel[1] = color.g * 0x55;
+      pixel[2] = color.b * 0x55;
+    }
+  }
+  return host_png_write(path, rgb, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Fonts and Resources
+//
+
+// Get the handle of a resource, which is its id
+ResHandle resource_get_handle(uint32_t resource_id) { return resource_id; }
+
+// Get a system font
+GFont fonts_get_system_font(const char *font_key) {
+  for (uint8_t ii = 0; ii < ARRAY_LENGTH(graphics_data.system_fonts); ii++) {
+    struct HostFont *font = &graphics_data.system_fonts[ii];
+    if (!font->name || strcmp(font->name, font_key) == 0) {
+      font->name = font_key;
+      return font;
+    }
+  }
+  return NULL;
+}
+
+// Load a custom font resource
+GFont fonts_load_custom_font(ResHandle handle) {
+  graphics_data.custom_font.name = "custom";
+  return &graphics_data.custom_font;
+}
+
+// Unload a custom font resource
+void fonts_unload_custom_font(GFont font) {}
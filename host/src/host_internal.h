@@ -0,0 +1,37 @@
+//! @file host_internal.h
+//! @brief Functions shared between the parts of the host SDK stand-in
+//!
+//! @author agent
+//! @date October 16, 2026
+
+#pragma once
+#include <pebble_host.h>
+
+//! Allocate memory on behalf of the app, counted against the emulated app heap
+//! @param size The number of bytes to allocate
+void *host_malloc(size_t size);
+
+//! Free memory allocated with host_malloc
+//! @param ptr The pointer to free, which may be NULL
+void host_free(void *ptr);
+
+//! Start drawing a frame, clearing the framebuffer to the window background unless it is clear
+//! @param background The background color of the top window
+//! @return The context to draw the frame with
+GContext *host_graphics_frame_begin(GColor background);
+
+//! Move where a layer draws from, in framebuffer coordinates
+//! @param ctx The context being drawn with
+//! @param origin The framebuffer position of the layer's origin
+void host_graphics_set_origin(GContext *ctx, GPoint origin);
+
+//! Reset the graphics state, freeing the framebuffer
+void host_graphics_reset(void);
+
+//! Write an 8 bit RGB image to a PNG file
+//! @param path The file to write
+//! @param rgb The pixels, 3 bytes each, row after row
+//! @param width The width of the image in pixels
+//! @param height The height of the image in pixels
+//! @return True if it was written
+bool host_png_write(const char *path, const uint8_t *rgb, uint16_t width, uint16_t height);
@@ -0,0 +1,823 @@
+// @file pebble_host.c
+// @brief Host stand-in for the Pebble SDK services
+//
+// Implements the non-graphics part of the SDK on a virtual clock. AppTimers
+// are kept in a table and fired in deadline order, then registration order,
+// as the clock is advanced, so every run is deterministic. Handles are ids
+// rather than pointers, so stale handles are harmless like on the watch.
+// Windows, layers, clicks, persist storage, vibes and wakeups are emulated
+// just far enough for the app, and everything it does is counted.
+//
+// @author agent
+// @date October 16, 2026
+
+#include "host_internal.h"
+#include <math.h>
+
+#define HOST_TIMER_COUNT 32     //< Maximum number of AppTimers registered at once
+#define HOST_PERSIST_COUNT 64   //< Maximum number of persist records
+#define HOST_WAKEUP_COUNT 8     //< Maximum number of scheduled wakeups, as on the watch
+#define HOST_WINDOW_COUNT 4     //< Maximum depth of the window stack
+#define HOST_LAYER_CHILDREN 4   //< Maximum number of children of a layer
+#define HOST_STATE_MAGIC 0x54484f53
+
+// AppTimer waiting on the virtual clock
+typedef struct {
+  uint32_t id;               //< Handle given to the app, 0 if the slot is free
+  uint64_t deadline;         //< Virtual epoch in milliseconds at which it fires
+  uint32_t sequence;         //< Registration order, to break ties between equal deadlines
+  AppTimerCallback callback; //< Callback to raise
+  void *data;                //< Data for the callback
+} HostTimer;
+
+// Persist record
+typedef struct {
+  uint32_t key;                          //< Key of the record
+  int16_t size;                          //< Size of the data, or -1 if the slot is free
+  uint8_t data[PERSIST_DATA_MAX_LENGTH]; //< Data of the record
+} HostPersistRecord;
+
+// Scheduled wakeup
+typedef struct {
+  WakeupId id;       //< Id of the wakeup, 0 if the slot is free
+  time_t timestamp;  //< Time the wakeup fires in seconds
+  int32_t cookie;    //< Cookie given when scheduling
+} HostWakeup;
+
+// State which outlives a launch of the app, saved between processes so each launch starts fresh
+typedef struct {
+  uint32_t magic;                                //< HOST_STATE_MAGIC
+  uint64_t clock_ms;                             //< Virtual epoch in milliseconds
+  HostStats stats;                               //< Counters of what the app did
+  HostPersistRecord persist[HOST_PERSIST_COUNT]; //< Persist store
+  HostWakeup wakeups[HOST_WAKEUP_COUNT];         //< Scheduled wakeups
+  WakeupId next_wakeup_id;                       //< Id given to the next wakeup
+} HostState;
+
+// Layer in a window's tree
+struct Layer {
+  GRect frame;                            //< Frame within the parent layer
+  LayerUpdateProc update_proc;            //< Procedure which draws the layer
+  Layer *children[HOST_LAYER_CHILDREN];   //< Child layers, drawn after this one
+  uint8_t child_count;                    //< Number of child layers
+};
+
+// Click subscriptions of one button
+typedef struct {
+  ClickHandler single;            //< Single click handler, also used for repeats
+  uint16_t repeat_interval_ms;    //< Interval between repeats, 0 if not repeating
+  ClickHandler long_down;         //< Long click handler when the delay passes
+  ClickHandler long_up;           //< Long click handler on release
+  uint16_t long_delay_ms;         //< Delay before a hold becomes a long click
+  ClickHandler raw_down;          //< Raw handler on press
+  ClickHandler raw_up;            //< Raw handler on release
+  void *raw_context;              //< Context given to the raw handlers
+} HostClickConfig;
+
+// Window on the stack
+struct Window {
+  Layer *root;                               //< Root layer, the size of the display
+  GColor background;                         //< Color drawn behind the root layer
+  ClickConfigProvider click_config_provider; //< Provider which subscribes the clicks
+  HostClickConfig clicks[NUM_BUTTONS];       //< Click subscriptions
+};
+
+// Click being handled
+struct HostClickRecognizer {
+  ButtonId button; //< Button which is clicked
+  bool repeating;  //< If this is a repeat of a held button
+};
+
+// Main data
+static struct {
+  HostState state;                         //< State which outlives a launch
+  HostTimer timers[HOST_TIMER_COUNT];      //< Registered AppTimers
+  uint32_t next_timer_id;                  //< Handle given to the next AppTimer
+  uint32_t next_timer_sequence;            //< Sequence of the next AppTimer
+  AppLaunchReason launch_reason;           //< Reason reported for this launch
+  HostEventLoop event_loop;                //< Driver run by app_event_loop
+  Window *windows[HOST_WINDOW_COUNT];      //< Window stack
+  uint8_t window_count;                    //< Number of windows on the stack
+  Window *configuring;                     //< Window whose click provider is running
+  bool dirty;                              //< If a layer was marked dirty since the last frame
+  AppFocusHandlers focus_handlers;         //< Subscribed focus handlers
+  size_t heap_used;                        //< Heap bytes in use by the app
+  void (*log_handler)(uint8_t level, const char *message); //< Handler for log lines
+  void (*frame_handler)(void);             //< Handler called after each frame
+  bool in_frame_handler;                   //< If the frame handler is running
+} host_data;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Memory
+//
+
+// Size header before every app allocation, padded to keep the allocation aligned
+typedef union {
+  size_t size;
+  long double align;
+} HostAllocation;
+
+// Allocate memory on behalf of the app
+void *host_malloc(size_t size) {
+  if (host_data.heap_used + size > HOST_HEAP_SIZE) {
+    return NULL;
+  }
+  HostAllocation *allocation = malloc(sizeof(HostAllocation) + size);
+  if (!allocation) {
+    return NULL;
+  }
+  allocation->size = size;
+  host_data.heap_used += size;
+  host_data.state.stats.allocations++;
+  if (host_data.heap_used > host_data.state.stats.heap_high_water) {
+    host_data.state.stats.heap_high_water = host_data.heap_used;
+  }
+  return allocation + 1;
+}
+
+// Free memory allocated with host_malloc
+void host_free(void *ptr) {
+  if (!ptr) {
+    return;
+  }
+  HostAllocation *allocation = (HostAllocation *)ptr - 1;
+  host_data.heap_used -= allocation->size;
+  host_data.state.stats.frees++;
+  free(allocation);
+}
+
+// Get the number of free bytes in the emulated app heap
+size_t heap_bytes_free(void) { return HOST_HEAP_SIZE - host_data.heap_used; }
+
+// Get the number of used bytes in the emulated app heap
+size_t heap_bytes_used(void) { return host_data.heap_used; }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Logging
+//
+
+// Log a message, through the handler if one is set
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number, const char *fmt,
+             ...) {
+  char message[256];
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(message, sizeof(message), fmt, args);
+  va_end(args);
+  if (host_data.log_handler) {
+    host_data.log_handler(log_level, message);
+  } else if (log_level == APP_LOG_LEVEL_INFO) {
+    printf("%s\n", message);
+  } else {
+    fprintf(stderr, "%s:%d> %s\n", src_filename, src_line_number, message);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Time
+//
+
+// Get the virtual time in seconds
+time_t host_time(time_t *tloc) {
+  time_t seconds = host_data.state.clock_ms / 1000;
+  if (tloc) {
+    (*tloc) = seconds;
+  }
+  return seconds;
+}
+
+// Get the virtual time in seconds and milliseconds
+uint16_t time_ms(time_t *tloc, uint16_t *out_ms) {
+  uint16_t ms = host_data.state.clock_ms % 1000;
+  host_time(tloc);
+  if (out_ms) {
+    (*out_ms) = ms;
+  }
+  return ms;
+}
+
+// Check the clock style, which is always 24 hour on the host so output doesn't depend on locale
+bool clock_is_24h_style(void) { return true; }
+
+// Sleep, which blocks the app without firing any timers
+void psleep(int millis) { host_data.state.clock_ms += millis; }
+
+// Get the virtual clock time
+uint64_t host_clock_now(void) { return host_data.state.clock_ms; }
+
+// Get a monotonic real time
+uint64_t host_time_ns(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Math
+//
+
+// Sine of an angle, scaled by TRIG_MAX_RATIO
+int32_t sin_lookup(int32_t angle) {
+  return (int32_t)lround(sin(angle * 2 * M_PI / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+// Cosine of an angle, scaled by TRIG_MAX_RATIO
+int32_t cos_lookup(int32_t angle) {
+  return (int32_t)lround(cos(angle * 2 * M_PI / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+// Angle of a vector, in [0, TRIG_MAX_ANGLE)
+int32_t atan2_lookup(int16_t y, int16_t x) {
+  int32_t angle = (int32_t)lround(atan2(y, x) * TRIG_MAX_ANGLE / (2 * M_PI));
+  return angle < 0 ? angle + TRIG_MAX_ANGLE : angle;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Persist Storage
+//
+
+// Find the record of a key, or NULL if it doesn't exist
+static HostPersistRecord *prv_persist_find(uint32_t key) {
+  for (uint8_t ii = 0; ii < HOST_PERSIST_COUNT; ii++) {
+    HostPersistRecord *record = &host_data.state.persist[ii];
+    if (record->size >= 0 && record->key == key) {
+      return record;
+    }
+  }
+  return NULL;
+}
+
+// Check if a key exists
+bool persist_exists(uint32_t key) { return prv_persist_find(key) != NULL; }
+
+// Get the size of the data of a key
+int persist_get_size(uint32_t key) {
+  HostPersistRecord *record = prv_persist_find(key);
+  return record ? record->size : E_DOES_NOT_EXIST;
+}
+
+// Read the data of a key
+int persist_read_data(uint32_t key, void *buffer, size_t buffer_size) {
+  HostPersistRecord *record = prv_persist_find(key);
+  if (!record) {
+    return E_DOES_NOT_EXIST;
+  }
+  size_t size = (size_t)record->size < buffer_size ? (size_t)record->size : buffer_size;
+  memcpy(buffer, record->data, size);
+  return size;
+}
+
+// Read an integer key, 0 if it doesn't exist
+int32_t persist_read_int(uint32_t key) {
+  int32_t value = 0;
+  persist_read_data(key, &value, sizeof(value));
+  return value;
+}
+
+// Write the data of a key
+int persist_write_data(uint32_t key, const void *data, size_t size) {
+  if (size > PERSIST_DATA_MAX_LENGTH) {
+    size = PERSIST_DATA_MAX_LENGTH;
+  }
+  HostPersistRecord *record = prv_persist_find(key);
+  for (uint8_t ii = 0; !record && ii < HOST_PERSIST_COUNT; ii++) {
+    if (host_data.state.persist[ii].size < 0) {
+      record = &host_data.state.persist[ii];
+    }
+  }
+  if (!record) {
+    return E_OUT_OF_STORAGE;
+  }
+  record->key = key;
+  record->size = size;
+  memcpy(record->data, data, size);
+  host_data.state.stats.persist_writes++;
+  return size;
+}
+
+// Write an integer key
+status_t persist_write_int(uint32_t key, int32_t value) {
+  int result = persist_write_data(key, &value, sizeof(value));
+  return result < 0 ? result : S_SUCCESS;
+}
+
+// Delete a key
+status_t persist_delete(uint32_t key) {
+  HostPersistRecord *record = prv_persist_find(key);
+  if (!record) {
+    return E_DOES_NOT_EXIST;
+  }
+  record->size = -1;
+  host_data.state.stats.persist_writes++;
+  return S_SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// AppTimers
+//
+
+// Find the timer of a handle, or NULL if it already fired or was cancelled
+static HostTimer *prv_timer_find(AppTimer *timer_handle) {
+  uint32_t id = (uint32_t)(uintptr_t)timer_handle;
+  for (uint8_t ii = 0; id && ii < HOST_TIMER_COUNT; ii++) {
+    if (host_data.timers[ii].id == id) {
+      return &host_data.timers[ii];
+    }
+  }
+  return NULL;
+}
+
+// Register a timer
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data) {
+  for (uint8_t ii = 0; ii < HOST_TIMER_COUNT; ii++) {
+    HostTimer *timer = &host_data.timers[ii];
+    if (!timer->id) {
+      (*timer) = (HostTimer){
+          .id = ++host_data.next_timer_id,
+          .deadline = host_data.state.clock_ms + timeout_ms,
+          .sequence = host_data.next_timer_sequence++,
+          .callback = callback,
+          .data = callback_data,
+      };
+      return (AppTimer *)(uintptr_t)timer->id;
+    }
+  }
+  return NULL;
+}
+
+// Reschedule a timer which hasn't fired yet
+bool app_timer_reschedule(AppTimer *timer_handle, uint32_t new_timeout_ms) {
+  HostTimer *timer = prv_timer_find(timer_handle);
+  if (!timer) {
+    return false;
+  }
+  timer->deadline = host_data.state.clock_ms + new_timeout_ms;
+  timer->sequence = host_data.next_timer_sequence++;
+  return true;
+}
+
+// Cancel a timer which hasn't fired yet
+void app_timer_cancel(AppTimer *timer_handle) {
+  HostTimer *timer = prv_timer_find(timer_handle);
+  if (timer) {
+    timer->id = 0;
+  }
+}
+
+// Get the next timer due by a deadline, or NULL if none is
+static HostTimer *prv_timer_next_due(uint64_t end) {
+  HostTimer *next = NULL;
+  for (uint8_t ii = 0; ii < HOST_TIMER_COUNT; ii++) {
+    HostTimer *timer = &host_data.timers[ii];
+    if (timer->id && timer->deadline <= end &&
+        (!next || timer->deadline < next->deadline ||
+         (timer->deadline == next->deadline && timer->sequence < next->sequence))) {
+      next = timer;
+    }
+  }
+  return next;
+}
+
+// Advance the virtual clock, firing the timers which fall due
+void host_run(uint64_t duration_ms) {
+  uint64_t end = host_data.state.clock_ms + duration_ms;
+  HostTimer *timer;
+  while ((timer = prv_timer_next_due(end))) {
+    if (timer->deadline > host_data.state.clock_ms) {
+      host_data.state.clock_ms = timer->deadline;
+    }
+    // free the slot first, since the handle is invalid once the callback is raised
+    HostTimer fired = (*timer);
+    timer->id = 0;
+    host_data.state.stats.timers_fired++;
+    fired.callback(fired.data);
+    host_render();
+  }
+  host_data.state.clock_ms = end;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Windows and Layers
+//
+
+// Create a layer
+Layer *layer_create(GRect frame) {
+  Layer *layer = host_malloc(sizeof(Layer));
+  if (layer) {
+    (*layer) = (Layer){.frame = frame};
+  }
+  return layer;
+}
+
+// Destroy a layer
+void layer_destroy(Layer *layer) { host_free(layer); }
+
+// Get the bounds of a layer, its frame at the origin
+GRect layer_get_bounds(const Layer *layer) {
+  return GRect(0, 0, layer->frame.size.w, layer->frame.size.h);
+}
+
+// Get the frame of a layer
+GRect layer_get_frame(const Layer *layer) { return layer->frame; }
+
+// Set the update procedure of a layer
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc) {
+  layer->update_proc = update_proc;
+}
+
+// Mark a layer to be drawn in the next frame
+void layer_mark_dirty(Layer *layer) { host_data.dirty = true; }
+
+// Add a child to a layer
+void layer_add_child(Layer *parent, Layer *child) {
+  if (parent->child_count < HOST_LAYER_CHILDREN) {
+    parent->children[parent->child_count++] = child;
+  }
+}
+
+// Create a window with a root layer the size of the display
+Window *window_create(void) {
+  Window *window = host_malloc(sizeof(Window));
+  if (window) {
+    (*window) = (Window){
+        .root = layer_create(GRect(0, 0, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT)),
+        .background = GColorWhite,
+    };
+  }
+  return window;
+}
+
+// Destroy a window, removing it from the stack
+void window_destroy(Window *window) {
+  for (uint8_t ii = 0; ii < host_data.window_count; ii++) {
+    if (host_data.windows[ii] == window) {
+      memmove(&host_data.windows[ii], &host_data.windows[ii + 1],
+              (host_data.window_count - ii - 1) * sizeof(Window *));
+      host_data.window_count--;
+      break;
+    }
+  }
+  layer_destroy(window->root);
+  host_free(window);
+}
+
+// Get the root layer of a window
+Layer *window_get_root_layer(const Window *window) { return window->root; }
+
+// Set the color drawn behind the root layer
+void window_set_background_color(Window *window, GColor background_color) {
+  window->background = background_color;
+}
+
+// Set the click config provider, which is run when the window is pushed
+void window_set_click_config_provider(Window *window, ClickConfigProvider click_config_provider) {
+  window->click_config_provider = click_config_provider;
+}
+
+// Push a window onto the stack
+void window_stack_push(Window *window, bool animated) {
+  if (host_data.window_count >= HOST_WINDOW_COUNT) {
+    return;
+  }
+  host_data.windows[host_data.window_count++] = window;
+  memset(window->clicks, 0, sizeof(window->clicks));
+  if (window->click_config_provider) {
+    host_data.configuring = window;
+    window->click_config_provider(window);
+    host_data.configuring = NULL;
+  }
+  host_data.dirty = true;
+}
+
+// Pop the top window from the stack
+Window *window_stack_pop(bool animated) {
+  if (!host_data.window_count) {
+    return NULL;
+  }
+  host_data.dirty = true;
+  return host_data.windows[--host_data.window_count];
+}
+
+// Draw a layer and its children
+static void prv_layer_draw(GContext *ctx, Layer *layer, GPoint origin) {
+  origin.x += layer->frame.origin.x;
+  origin.y += layer->frame.origin.y;
+  if (layer->update_proc) {
+    host_graphics_set_origin(ctx, origin);
+    layer->update_proc(layer, ctx);
+  }
+  for (uint8_t ii = 0; ii < layer->child_count; ii++) {
+    prv_layer_draw(ctx, layer->children[ii], origin);
+  }
+}
+
+// Render a frame if any layer is dirty
+void host_render(void) {
+  if (!host_data.dirty || !host_data.window_count) {
+    return;
+  }
+  host_data.dirty = false;
+  Window *window = host_data.windows[host_data.window_count - 1];
+  GContext *ctx = host_graphics_frame_begin(window->background);
+  prv_layer_draw(ctx, window->root, GPointZero);
+  host_data.state.stats.frames++;
+  if (host_data.frame_handler && !host_data.in_frame_handler) {
+    host_data.in_frame_handler = true;
+    host_data.frame_handler();
+    host_data.in_frame_handler = false;
+  }
+}
+
+// Mark every layer dirty and render a frame, without calling the frame handler
+void host_redraw(void) {
+  bool in_frame_handler = host_data.in_frame_handler;
+  host_data.in_frame_handler = true;
+  host_data.dirty = true;
+  host_render();
+  host_data.in_frame_handler = in_frame_handler;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Clicks
+//
+
+// Get the click subscriptions of a button of the window being configured
+static HostClickConfig *prv_click_config(ButtonId button_id) {
+  return host_data.configuring && button_id < NUM_BUTTONS
+             ? &host_data.configuring->clicks[button_id]
+             : NULL;
+}
+
+// Subscribe a single click handler
+void window_single_click_subscribe(ButtonId button_id, ClickHandler handler) {
+  HostClickConfig *config = prv_click_config(button_id);
+  if (config) {
+    config->single = handler;
+    config->repeat_interval_ms = 0;
+  }
+}
+
+// Subscribe a single click handler which repeats while held
+void window_single_repeating_click_subscribe(ButtonId button_id, uint16_t repeat_interval_ms,
+                                             ClickHandler handler) {
+  HostClickConfig *config = prv_click_config(button_id);
+  if (config) {
+    config->single = handler;
+    config->repeat_interval_ms = repeat_interval_ms;
+  }
+}
+
+// Subscribe long click handlers
+void window_long_click_subscribe(ButtonId button_id, uint16_t delay_ms, ClickHandler down_handler,
+                                 ClickHandler up_handler) {
+  HostClickConfig *config = prv_click_config(button_id);
+  if (config) {
+    config->long_down = down_handler;
+    config->long_up = up_handler;
+    config->long_delay_ms = delay_ms ? delay_ms : 500;
+  }
+}
+
+// Subscribe raw click handlers
+void window_raw_click_subscribe(ButtonId button_id, ClickHandler down_handler,
+                                ClickHandler up_handler, void *context) {
+  HostClickConfig *config = prv_click_config(button_id);
+  if (config) {
+    config->raw_down = down_handler;
+    config->raw_up = up_handler;
+    config->raw_context = context;
+  }
+}
+
+// Check if a click is a repeat of a held button
+bool click_recognizer_is_repeating(ClickRecognizerRef recognizer) {
+  return recognizer->repeating;
+}
+
+// Raise a click handler, then render
+static void prv_click_raise(ClickHandler handler, struct HostClickRecognizer *recognizer,
+                            void *context) {
+  if (handler) {
+    handler(recognizer, context);
+    host_render();
+  }
+}
+
+// Check if the app still has a window on the stack
+bool host_app_is_running(void) { return host_data.window_count > 0; }
+
+// Get the click subscriptions of a button of the top window
+static HostClickConfig *prv_click_config_top(ButtonId button) {
+  if (!host_data.window_count || button >= NUM_BUTTONS) {
+    return NULL;
+  }
+  return &host_data.windows[host_data.window_count - 1]->clicks[button];
+}
+
+// Inject a click
+void host_click(ButtonId button, HostClick click) {
+  HostClickConfig *config = prv_click_config_top(button);
+  if (!config) {
+    return;
+  }
+  Window *window = host_data.windows[host_data.window_count - 1];
+  struct HostClickRecognizer recognizer = {.button = button};
+  prv_click_raise(config->raw_down, &recognizer, config->raw_context);
+  if (click == HostClickLong && config->long_down) {
+    host_run(config->long_delay_ms);
+    prv_click_raise(config->long_down, &recognizer, window);
+    prv_click_raise(config->long_up, &recognizer, window);
+  } else {
+    prv_click_raise(config->single, &recognizer, window);
+  }
+  prv_click_raise(config->raw_up, &recognizer, config->raw_context);
+}
+
+// Inject a held button which repeats
+void host_click_repeat(ButtonId button, uint16_t count) {
+  HostClickConfig *config = prv_click_config_top(button);
+  if (!config || !count) {
+    return;
+  }
+  Window *window = host_data.windows[host_data.window_count - 1];
+  struct HostClickRecognizer recognizer = {.button = button};
+  prv_click_raise(config->raw_down, &recognizer, config->raw_context);
+  prv_click_raise(config->single, &recognizer, window);
+  for (uint16_t ii = 1; ii < count && config->repeat_interval_ms; ii++) {
+    host_run(config->repeat_interval_ms);
+    recognizer.repeating = true;
+    prv_click_raise(config->single, &recognizer, window);
+  }
+  prv_click_raise(config->raw_up, &recognizer, config->raw_context);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Services
+//
+
+// Subscribe to focus changes
+void app_focus_service_subscribe_handlers(AppFocusHandlers handlers) {
+  host_data.focus_handlers = handlers;
+}
+
+// Unsubscribe from focus changes
+void app_focus_service_unsubscribe(void) { host_data.focus_handlers = (AppFocusHandlers){0}; }
+
+// Inject the app losing or regaining focus
+void host_focus(bool in_focus) {
+  if (host_data.focus_handlers.will_focus) {
+    host_data.focus_handlers.will_focus(in_focus);
+  }
+  if (host_data.focus_handlers.did_focus) {
+    host_data.focus_handlers.did_focus(in_focus);
+  }
+  host_render();
+}
+
+// Start a vibe pattern
+void vibes_enqueue_custom_pattern(VibePattern pattern) { host_data.state.stats.vibes++; }
+
+// Start a short vibe
+void vibes_short_pulse(void) { host_data.state.stats.vibes++; }
+
+// Start a long vibe
+void vibes_long_pulse(void) { host_data.state.stats.vibes++; }
+
+// Stop vibing, which isn't counted
+void vibes_cancel(void) {}
+
+// Schedule a wakeup, failing like the watch does when it is in the past, another wakeup is within
+// a minute of it, or every slot is taken
+WakeupId wakeup_schedule(time_t timestamp, int32_t cookie, bool notify_if_missed) {
+  if (timestamp < host_time(NULL)) {
+    return E_INVALID_ARGUMENT;
+  }
+  HostWakeup *free_slot = NULL;
+  for (uint8_t ii = 0; ii < HOST_WAKEUP_COUNT; ii++) {
+    HostWakeup *wakeup = &host_data.state.wakeups[ii];
+    if (!wakeup->id) {
+      free_slot = free_slot ? free_slot : wakeup;
+    } else if (llabs((long long)(wakeup->timestamp - timestamp)) < SECONDS_PER_MINUTE) {
+      return E_RANGE;
+    }
+  }
+  if (!free_slot) {
+    return E_OUT_OF_RESOURCES;
+  }
+  (*free_slot) = (HostWakeup){
+      .id = ++host_data.state.next_wakeup_id,
+      .timestamp = timestamp,
+      .cookie = cookie,
+  };
+  host_data.state.stats.wakeups++;
+  return free_slot->id;
+}
+
+// Cancel a wakeup
+void wakeup_cancel(WakeupId wakeup_id) {
+  for (uint8_t ii = 0; ii < HOST_WAKEUP_COUNT; ii++) {
+    if (host_data.state.wakeups[ii].id == wakeup_id) {
+      host_data.state.wakeups[ii].id = 0;
+    }
+  }
+}
+
+// Cancel every wakeup
+void wakeup_cancel_all(void) { memset(host_data.state.wakeups, 0, sizeof(host_data.state.wakeups)); }
+
+// Get the time of a wakeup
+bool wakeup_query(WakeupId wakeup_id, time_t *timestamp) {
+  for (uint8_t ii = 0; ii < HOST_WAKEUP_COUNT; ii++) {
+    if (host_data.state.wakeups[ii].id == wakeup_id) {
+      if (timestamp) {
+        (*timestamp) = host_data.state.wakeups[ii].timestamp;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+// Get the earliest scheduled wakeup
+bool host_wakeup_next(time_t *timestamp) {
+  bool found = false;
+  for (uint8_t ii = 0; ii < HOST_WAKEUP_COUNT; ii++) {
+    HostWakeup *wakeup = &host_data.state.wakeups[ii];
+    if (wakeup->id && (!found || wakeup->timestamp < *timestamp)) {
+      (*timestamp) = wakeup->timestamp;
+      found = true;
+    }
+  }
+  return found;
+}
+
+// Get the reason the app was launched
+AppLaunchReason launch_reason(void) { return host_data.launch_reason; }
+
+// Run the event loop driver
+void app_event_loop(void) {
+  host_render();
+  if (host_data.event_loop) {
+    host_data.event_loop();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Host Controls
+//
+
+// Reset the SDK state to a fresh watch
+void host_reset(uint64_t epoch_ms) {
+  // format wall clock times the same way on every machine
+  setenv("TZ", "UTC", 1);
+  tzset();
+  host_graphics_reset();
+  memset(&host_data, 0, sizeof(host_data));
+  host_data.state.magic = HOST_STATE_MAGIC;
+  host_data.state.clock_ms = epoch_ms;
+  for (uint8_t ii = 0; ii < HOST_PERSIST_COUNT; ii++) {
+    host_data.state.persist[ii].size = -1;
+  }
+}
+
+// Set how the next launch of the app starts
+void host_launch(AppLaunchReason reason, HostEventLoop event_loop) {
+  host_data.launch_reason = reason;
+  host_data.event_loop = event_loop;
+}
+
+// Save the state which outlives a launch of the app
+bool host_state_save(const char *path) {
+  FILE *file = fopen(path, "wb");
+  if (!file) {
+    return false;
+  }
+  bool saved = fwrite(&host_data.state, sizeof(HostState), 1, file) == 1;
+  return fclose(file) == 0 && saved;
+}
+
+// Load the state saved by another process
+bool host_state_load(const char *path) {
+  FILE *file = fopen(path, "rb");
+  if (!file) {
+    return false;
+  }
+  HostState state;
+  bool loaded = fread(&state, sizeof(HostState), 1, file) == 1 && state.magic == HOST_STATE_MAGIC;
+  fclose(file);
+  if (loaded) {
+    host_data.state = state;
+  }
+  return loaded;
+}
+
+// Get the counters of what the app did
+const HostStats *host_get_stats(void) { return &host_data.state.stats; }
+
+// Set the handler for log lines
+void host_set_log_handler(void (*handler)(uint8_t level, const char *message)) {
+  host_data.log_handler = handler;
+}
+
+// Set a handler called after every frame is rendered
+void host_set_frame_handler(void (*handler)(void)) { host_data.frame_handler = handler; }
@@ -0,0 +1,138 @@
+// @file png.c
+// @brief Minimal PNG writer for host framebuffer dumps
+//
+// Writes 8 bit RGB images with the pixel data in stored, uncompressed
+// deflate blocks, which every PNG reader accepts and needs no zlib.
+//
+// @author agent
+// @date October 16, 2026
+
+#include "host_internal.h"
+
+#define PNG_STORED_BLOCK_MAX 65535 //< Largest stored deflate block
+
+// Running checksums of the chunk and zlib stream being written
+static struct {
+  uint32_t crc_table[256]; //< CRC-32 of every byte value
+  uint32_t crc;            //< CRC-32 of the current chunk
+  uint32_t adler_a;        //< Adler-32 sum of the bytes of the zlib stream
+  uint32_t adler_b;        //< Adler-32 sum of the sums of the zlib stream
+} png_data;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Checksums
+//
+
+// Build the CRC-32 table on first use
+static void prv_crc_table_build(void) {
+  for (uint32_t ii = 0; ii < 256; ii++) {
+    uint32_t crc = ii;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = crc & 1 ? 0xEDB88320 ^ (crc >> 1) : crc >> 1;
+    }
+    png_data.crc_table[ii] = crc;
+  }
+}
+
+// Write bytes to the file, adding them to the chunk CRC
+static void prv_write(FILE *file, const uint8_t *data, size_t size) {
+  for (size_t ii = 0; ii < size; ii++) {
+    png_data.crc = png_data.crc_table[(png_data.crc ^ data[ii]) & 0xFF] ^ (png_data.crc >> 8);
+  }
+  fwrite(data, 1, size, file);
+}
+
+// Write bytes of the zlib stream, adding them to the Adler-32 sums as well
+static void prv_write_zlib(FILE *file, const uint8_t *data, size_t size) {
+  for (size_t ii = 0; ii < size; ii++) {
+    png_data.adler_a = (png_data.adler_a + data[ii]) % 65521;
+    png_data.adler_b = (png_data.adler_b + png_data.adler_a) % 65521;
+  }
+  prv_write(file, data, size);
+}
+
+// Write a big endian 32 bit value
+static void prv_write_u32(FILE *file, uint32_t value) {
+  uint8_t bytes[] = {value >> 24, value >> 16, value >> 8, value};
+  prv_write(file, bytes, sizeof(bytes));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Chunks
+//
+
+// Start a chunk of a given length and type
+static void prv_chunk_begin(FILE *file, uint32_t length, const char *type) {
+  prv_write_u32(file, length);
+  png_data.crc = 0xFFFFFFFF;
+  prv_write(file, (const uint8_t *)type, 4);
+}
+
+// End a chunk with its CRC
+static void prv_chunk_end(FILE *file) {
+  uint32_t crc = png_data.crc ^ 0xFFFFFFFF;
+  prv_write_u32(file, crc);
+}
+
+// Write the pixel rows as a zlib stream of stored deflate blocks, each row led by filter type 0
+static void prv_chunk_image_data(FILE *file, const uint8_t *rgb, uint16_t width, uint16_t height) {
+  size_t row_size = (size_t)width * 3 + 1;
+  size_t raw_size = row_size * height;
+  size_t block_count = (raw_size + PNG_STORED_BLOCK_MAX - 1) / PNG_STORED_BLOCK_MAX;
+  // zlib header, 5 bytes per block header, the data, then the Adler-32
+  prv_chunk_begin(file, 2 + block_count * 5 + raw_size + 4, "IDAT");
+  const uint8_t zlib_header[] = {0x78, 0x01};
+  prv_write(file, zlib_header, sizeof(zlib_header));
+  png_data.adler_a = 1;
+  png_data.adler_b = 0;
+  size_t offset = 0;
+  while (offset < raw_size) {
+    uint16_t length =
+        raw_size - offset > PNG_STORED_BLOCK_MAX ? PNG_STORED_BLOCK_MAX : raw_size - offset;
+    bool last = offset + length == raw_size;
+    uint8_t block_header[] = {last, length, length >> 8, ~length, (uint16_t)~length >> 8};
+    prv_write(file, block_header, sizeof(block_header));
+    for (size_t end = offset + length; offset < end;) {
+      size_t column = offset % row_size;
+      if (column == 0) {
+        const uint8_t filter = 0;
+        prv_write_zlib(file, &filter, 1);
+        offset++;
+        continue;
+      }
+      size_t run = row_size - column < end - offset ? row_size - column : end - offset;
+      prv_write_zlib(file, rgb + offset / row_size * width * 3 + column - 1, run);
+      offset += run;
+    }
+  }
+  uint32_t adler = png_data.adler_b << 16 | png_data.adler_a;
+  prv_write_u32(file, adler);
+  prv_chunk_end(file);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// API Implementation
+//
+
+// Write an 8 bit RGB image to a PNG file
+bool host_png_write(const char *path, const uint8_t *rgb, uint16_t width, uint16_t height) {
+  FILE *file = fopen(path, "wb");
+  if (!file) {
+    return false;
+  }
+  prv_crc_table_build();
+  const uint8_t signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  fwrite(signature, 1, sizeof(signature), file);
+  // width, height, 8 bit depth, RGB, default compression, filtering and no interlacing
+  prv_chunk_begin(file, 13, "IHDR");
+  prv_write_u32(file, width);
+  prv_write_u32(file, height);
+  const uint8_t header[] = {8, 2, 0, 0, 0};
+  prv_write(file, header, sizeof(header));
+  prv_chunk_end(file);
+  prv_chunk_image_data(file, rgb, width, height);
+  prv_chunk_begin(file, 0, "IEND");
+  prv_chunk_end(file);
+  bool written = !ferror(file);
+  return fclose(file) == 0 && written;
+}
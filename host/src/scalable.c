@@ -0,0 +1,33 @@
+// @file scalable.c
+// @brief Host stand-in for the pebble-scalable fonts
+//
+// @author agent
+// @date October 16, 2026
+
+#include <pebble-scalable/pebble-scalable.h>
+
+#define SCALABLE_FONT_COUNT 8 //< Maximum number of font ids
+
+// Fonts registered for each id
+static SFontDistinct scalable_fonts[SCALABLE_FONT_COUNT];
+
+// Register the fonts to use for an id
+void scl_set_fonts_distinct(int id, SFontDistinct fonts) {
+  if (id >= 0 && id < SCALABLE_FONT_COUNT) {
+    scalable_fonts[id] = fonts;
+  }
+}
+
+// Get the font registered for an id on this platform
+GFont scl_get_font(int id) {
+  if (id < 0 || id >= SCALABLE_FONT_COUNT) {
+    return NULL;
+  }
+#if defined(PBL_PLATFORM_EMERY)
+  return scalable_fonts[id].e;
+#elif defined(PBL_PLATFORM_GABBRO)
+  return scalable_fonts[id].g;
+#else
+  return scalable_fonts[id].o;
+#endif
+}
@@ -0,0 +1,240 @@
+// @file bench.c
+// @brief Runs the app's benchmarks and checks them against a baseline
+//
+// Launches the app built with BENCHMARK several times, each in its own
+// process, and collects the "bench,<name>,<iterations>,<total us>" lines it
+// logs. Prints the fastest run of each benchmark in the same format, since
+// the benchmarks are short enough that other load on the machine only ever
+// slows them down. Then compares them against a baseline file of earlier
+// results, and exits with an error if any benchmark got slower than the
+// threshold allows. With --update they are written as the new baseline
+// instead. Timings drift with the machine's load and clock speed, so the
+// baseline is best recorded on the same machine just before a change.
+//
+// @author agent
+// @date October 16, 2026
+
+#include <pebble_host.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define BENCH_START_EPOCH_MS 1798761600000ULL //< Midnight UTC on January 1, 2027
+#define BENCH_RUNS 15                         //< Launches of the app to take the fastest of
+#define BENCH_MAX_RESULTS 64                  //< Most benchmarks which can be collected
+#define BENCH_NAME_SIZE 32
+#define BENCH_LINE_SIZE 128
+#define BENCH_THRESHOLD_DEFAULT 10 //< Percent slower than the baseline which fails
+#define BENCH_NOISE_US 50          //< Slowdowns of fewer microseconds never fail
+
+// The app's entry point, renamed by the Makefile
+int app_main(void);
+
+// Timings of one benchmark over every run
+typedef struct {
+  char name[BENCH_NAME_SIZE]; //< Name of the benchmark
+  uint32_t iterations;        //< Iterations the benchmark timed
+  uint64_t us[BENCH_RUNS];    //< Total microseconds of each run
+  uint8_t runs;               //< Runs the benchmark was logged in
+} BenchResult;
+
+// Main data
+static struct {
+  FILE *pipe;                              //< Where a run writes its benchmark lines
+  BenchResult results[BENCH_MAX_RESULTS];  //< Benchmarks in the order first logged
+  uint8_t result_count;                    //< Number of benchmarks collected
+} bench_data;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Results
+//
+
+// Find a benchmark which ran by name
+static BenchResult *prv_result_find(const char *name) {
+  for (uint8_t ii = 0; ii < bench_data.result_count; ii++) {
+    if (strcmp(bench_data.results[ii].name, name) == 0) {
+      return &bench_data.results[ii];
+    }
+  }
+  return NULL;
+}
+
+// Find a benchmark by name, adding it if it is new
+static BenchResult *prv_result_get(const char *name) {
+  BenchResult *result = prv_result_find(name);
+  if (result) {
+    return result;
+  }
+  if (bench_data.result_count == BENCH_MAX_RESULTS) {
+    return NULL;
+  }
+  result = &bench_data.results[bench_data.result_count++];
+  snprintf(result->name, sizeof(result->name), "%s", name);
+  return result;
+}
+
+// Parse a "bench,<name>,<iterations>,<us>" line, returning false if it is something else
+static bool prv_line_parse(const char *line, char *name, uint32_t *iterations, uint64_t *us) {
+  unsigned long long total;
+  if (sscanf(line, "bench,%31[^,],%u,%llu", name, iterations, &total) != 3) {
+    return false;
+  }
+  *us = total;
+  return true;
+}
+
+// Get the fastest of a benchmark's runs
+static uint64_t prv_result_fastest(const BenchResult *result) {
+  uint64_t fastest = result->us[0];
+  for (uint8_t ii = 1; ii < result->runs; ii++) {
+    if (result->us[ii] < fastest) {
+      fastest = result->us[ii];
+    }
+  }
+  return fastest;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Running
+//
+
+// Pass the app's benchmark lines to the parent process and drop everything else it logs
+static void prv_log_handler(uint8_t level, const char *message) {
+  if (strncmp(message, "bench,", 6) == 0) {
+    fprintf(bench_data.pipe, "%s\n", message);
+  }
+}
+
+// Stay open long enough to draw the first frame, which runs the drawing benchmarks
+static void prv_event_loop(void) {
+  host_run(1000);
+}
+
+// Launch the app in a child process, so its static data starts fresh, and collect its results
+static bool prv_run(void) {
+  int fds[2];
+  if (pipe(fds) != 0) {
+    return false;
+  }
+  fflush(stdout);
+  pid_t pid = fork();
+  if (pid < 0) {
+    return false;
+  }
+  if (pid == 0) {
+    close(fds[0]);
+    bench_data.pipe = fdopen(fds[1], "w");
+    host_reset(BENCH_START_EPOCH_MS);
+    host_set_log_handler(prv_log_handler);
+    host_launch(APP_LAUNCH_USER, prv_event_loop);
+    app_main();
+    fclose(bench_data.pipe);
+    _exit(0);
+  }
+  close(fds[1]);
+  FILE *pipe = fdopen(fds[0], "r");
+  char line[BENCH_LINE_SIZE];
+  while (fgets(line, sizeof(line), pipe)) {
+    char name[BENCH_NAME_SIZE];
+    uint32_t iterations;
+    uint64_t us;
+    BenchResult *result;
+    if (prv_line_parse(line, name, &iterations, &us) && (result = prv_result_get(name)) &&
+        result->runs < BENCH_RUNS) {
+      result->iterations = iterations;
+      result->us[result->runs++] = us;
+    }
+  }
+  fclose(pipe);
+  int status;
+  return waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Baseline
+//
+
+// Write the fastest runs as the new baseline
+static bool prv_baseline_write(const char *path) {
+  FILE *file = fopen(path, "w");
+  if (!file) {
+    return false;
+  }
+  for (uint8_t ii = 0; ii < bench_data.result_count; ii++) {
+    BenchResult *result = &bench_data.results[ii];
+    fprintf(file, "bench,%s,%u,%llu\n", result->name, result->iterations,
+            (unsigned long long)prv_result_fastest(result));
+  }
+  return fclose(file) == 0;
+}
+
+// Compare the fastest runs against the baseline, returning the number of regressions
+static uint32_t prv_baseline_compare(FILE *file, uint32_t threshold) {
+  uint32_t regressions = 0;
+  char line[BENCH_LINE_SIZE];
+  while (fgets(line, sizeof(line), file)) {
+    char name[BENCH_NAME_SIZE];
+    uint32_t iterations;
+    uint64_t base_us;
+    if (!prv_line_parse(line, name, &iterations, &base_us)) {
+      continue;
+    }
+    BenchResult *result = prv_result_find(name);
+    if (!result) {
+      fprintf(stderr, "bench: %s is in the baseline but no longer runs\n", name);
+      continue;
+    }
+    // rescale the baseline if the iteration count changed
+    if (iterations != result->iterations && iterations) {
+      base_us = base_us * result->iterations / iterations;
+    }
+    uint64_t us = prv_result_fastest(result);
+    if (us > base_us + BENCH_NOISE_US && us * 100 > base_us * (100 + threshold)) {
+      fprintf(stderr, "bench: %s regressed from %llu us to %llu us (+%llu%%)\n", name,
+              (unsigned long long)base_us, (unsigned long long)us,
+              (unsigned long long)(base_us ? (us - base_us) * 100 / base_us : 0));
+      regressions++;
+    }
+  }
+  return regressions;
+}
+
+int main(int argc, char **argv) {
+  bool update = argc > 1 && strcmp(argv[1], "--update") == 0;
+  const char *baseline_path = argc > 1 + update ? argv[1 + update] : NULL;
+  uint32_t threshold = argc > 2 + update ? atoi(argv[2 + update]) : BENCH_THRESHOLD_DEFAULT;
+  for (uint8_t ii = 0; ii < BENCH_RUNS; ii++) {
+    if (!prv_run()) {
+      fprintf(stderr, "bench: run %u failed\n", ii);
+      return 1;
+    }
+  }
+  for (uint8_t ii = 0; ii < bench_data.result_count; ii++) {
+    BenchResult *result = &bench_data.results[ii];
+    printf("bench,%s,%u,%llu\n", result->name, result->iterations,
+           (unsigned long long)prv_result_fastest(result));
+  }
+  if (!baseline_path) {
+    return 0;
+  }
+  if (update) {
+    if (!prv_baseline_write(baseline_path)) {
+      fprintf(stderr, "bench: can't write %s\n", baseline_path);
+      return 1;
+    }
+    return 0;
+  }
+  FILE *file = fopen(baseline_path, "r");
+  if (!file) {
+    fprintf(stderr, "bench: no baseline at %s, run with --update to record one\n",
+            baseline_path);
+    return 0;
+  }
+  uint32_t regressions = prv_baseline_compare(file, threshold);
+  fclose(file);
+  if (regressions) {
+    fprintf(stderr, "bench: %u benchmarks more than %u%% slower than the baseline\n",
+            regressions, threshold);
+  }
+  return regressions ? 1 : 0;
+}
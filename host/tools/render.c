@@ -0,0 +1,235 @@
+// @file render.c
+// @brief Checks that every frame the app draws matches a full redraw
+//
+// The app keeps the last frame in the framebuffer and only draws what
+// changed, so each scenario here checks every few frames that what it drew
+// is exactly what a full redraw draws. The framebuffer is inverted before
+// the full redraw, so any pixel the full redraw misses differs as well.
+// Logs "render,<scenario>,<frames>,<checks>,<mismatched frames>" and then
+// "render,<scenario>,<primitive>,<calls>,<pixels>,<us>" for each primitive
+// the app's own frames used, saves the last frame of each scenario as a PNG,
+// along with both versions of the first mismatched frames, and exits with an
+// error if any frame mismatched.
+//
+// @author agent
+// @date October 16, 2026
+
+#include <pebble_host.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "drawing.h"
+
+#define RENDER_START_EPOCH_MS 1798761600000ULL //< Midnight UTC on January 1, 2027
+#define RENDER_CHECK_INTERVAL 5                //< Frames drawn between checks
+#define RENDER_MISMATCH_DUMPS 3                //< Mismatched frames saved per scenario
+#define RENDER_PATH_SIZE 256
+#define MSEC_IN_SEC 1000
+#define MSEC_IN_MIN (60 * MSEC_IN_SEC)
+#define MSEC_IN_HR (60 * MSEC_IN_MIN)
+
+// The app's entry point, renamed by the Makefile
+int app_main(void);
+
+// A scripted scenario
+typedef struct {
+  const char *name;         //< Name of the scenario in the log and file names
+  HostEventLoop event_loop; //< What happens while the app is open
+} RenderScenario;
+
+// Main data
+static struct {
+  const RenderScenario *scenario;             //< Scenario being run
+  const char *name;                           //< Name of the scenario being run
+  const char *out_dir;                        //< Directory the PNGs are saved in
+  uint8_t *incremental;                       //< Copy of the frame as the app drew it
+  uint8_t *full;                              //< Copy of the frame as a full redraw draws it
+  uint32_t frames;                            //< Frames the app drew
+  uint32_t checks;                            //< Frames checked against a full redraw
+  uint32_t mismatches;                        //< Frames which differed from a full redraw
+  bool covered;                               //< If a notification is drawn over the app
+  HostPrimitiveStats totals[HostPrimitiveCount]; //< Costs of the app's own frames
+  HostPrimitiveStats counted[HostPrimitiveCount]; //< Counters already added to the totals
+} render_data;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Checking
+//
+
+// Add the costs since the counters were last read to the totals
+static void prv_totals_add(bool count) {
+  const HostPrimitiveStats *stats = host_graphics_get_stats();
+  for (uint8_t ii = 0; ii < HostPrimitiveCount; ii++) {
+    if (count) {
+      render_data.totals[ii].calls += stats[ii].calls - render_data.counted[ii].calls;
+      render_data.totals[ii].pixels += stats[ii].pixels - render_data.counted[ii].pixels;
+      render_data.totals[ii].ns += stats[ii].ns - render_data.counted[ii].ns;
+    }
+    render_data.counted[ii] = stats[ii];
+  }
+}
+
+// Save a copy of the framebuffer as a PNG in the output directory
+static void prv_png_write(const char *suffix, const uint8_t *data) {
+  char path[RENDER_PATH_SIZE];
+  snprintf(path, sizeof(path), "%s/%s%s.png", render_data.out_dir, render_data.name, suffix);
+  if (!host_frame_buffer_write_png(path, data)) {
+    fprintf(stderr, "render: can't write %s\n", path);
+  }
+}
+
+// Check the frame the app just drew against a full redraw over the inverted frame. The full
+// redraw becomes the frame the app continues from, and its costs aren't counted
+static void prv_frame_check(void) {
+  host_frame_buffer_copy(render_data.incremental);
+  host_frame_buffer_invert();
+  drawing_invalidate_frame();
+  host_redraw();
+  host_frame_buffer_copy(render_data.full);
+  prv_totals_add(false);
+  render_data.checks++;
+  uint32_t diff = host_frame_buffer_diff(render_data.incremental, render_data.full);
+  if (!diff) {
+    return;
+  }
+  fprintf(stderr, "render: %s frame %u differs from a full redraw in %u pixels\n",
+          render_data.name, render_data.frames, diff);
+  if (render_data.mismatches++ < RENDER_MISMATCH_DUMPS) {
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), "-%u-incremental", render_data.frames);
+    prv_png_write(suffix, render_data.incremental);
+    snprintf(suffix, sizeof(suffix), "-%u-full", render_data.frames);
+    prv_png_write(suffix, render_data.full);
+  }
+}
+
+// Count each frame the app draws, checking every few of them unless a notification covers them
+static void prv_frame_handler(void) {
+  render_data.frames++;
+  prv_totals_add(true);
+  if (!render_data.covered && render_data.frames % RENDER_CHECK_INTERVAL == 0) {
+    prv_frame_check();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Scenarios
+//
+
+// Set a countdown on the selected timer from the edit mode it opens in, then start it
+static void prv_countdown_set(uint16_t minutes) {
+  host_run(MSEC_IN_SEC);
+  host_click_repeat(BUTTON_ID_UP, minutes);
+  // minutes, seconds, then start
+  host_click(BUTTON_ID_SELECT, HostClickSingle);
+  host_click(BUTTON_ID_SELECT, HostClickSingle);
+}
+
+// Count down 2 minutes and keep counting up past the expiry
+static void prv_scenario_countdown(void) {
+  prv_countdown_set(2);
+  host_run(3 * MSEC_IN_MIN);
+}
+
+// Edit a countdown back and forth, animating the focus and text, then reset it with a long click
+static void prv_scenario_edit(void) {
+  host_run(MSEC_IN_SEC);
+  host_click_repeat(BUTTON_ID_UP, 30);
+  host_click_repeat(BUTTON_ID_DOWN, 12);
+  host_click(BUTTON_ID_SELECT, HostClickSingle);
+  host_click_repeat(BUTTON_ID_UP, 45);
+  host_click(BUTTON_ID_SELECT, HostClickSingle);
+  host_run(10 * MSEC_IN_SEC);
+  host_click(BUTTON_ID_SELECT, HostClickLong);
+  host_run(5 * MSEC_IN_SEC);
+}
+
+// Cover a running countdown with a notification, which draws over the framebuffer, so the app
+// has to draw everything once it regains focus
+static void prv_scenario_focus(void) {
+  prv_countdown_set(5);
+  host_run(30 * MSEC_IN_SEC);
+  render_data.covered = true;
+  host_focus(false);
+  host_frame_buffer_invert();
+  host_run(5 * MSEC_IN_SEC);
+  render_data.covered = false;
+  host_focus(true);
+  // check the frame drawn on regaining focus
+  host_run(0);
+  prv_frame_check();
+  host_run(30 * MSEC_IN_SEC);
+}
+
+// Count down 30 minutes and stay open for hours
+static void prv_scenario_hours(void) {
+  prv_countdown_set(30);
+  host_run(2 * MSEC_IN_HR);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Running
+//
+
+// Run the scenario, then check and save the last frame while the app is still open
+static void prv_event_loop(void) {
+  render_data.scenario->event_loop();
+  prv_frame_check();
+  prv_png_write("", NULL);
+}
+
+// Run a scenario in a child process, so the app's static data starts fresh
+static bool prv_scenario_run(const RenderScenario *scenario) {
+  fflush(stdout);
+  pid_t pid = fork();
+  if (pid < 0) {
+    return false;
+  }
+  if (pid == 0) {
+    render_data.scenario = scenario;
+    render_data.name = scenario->name;
+    host_reset(RENDER_START_EPOCH_MS);
+    host_set_frame_handler(prv_frame_handler);
+    host_launch(APP_LAUNCH_USER, prv_event_loop);
+    app_main();
+    printf("render,%s,%u,%u,%u\n", scenario->name, render_data.frames, render_data.checks,
+           render_data.mismatches);
+    for (uint8_t ii = 0; ii < HostPrimitiveCount; ii++) {
+      const HostPrimitiveStats *totals = &render_data.totals[ii];
+      if (totals->calls) {
+        printf("render,%s,%s,%u,%llu,%llu\n", scenario->name, host_graphics_primitive_name(ii),
+               totals->calls, (unsigned long long)totals->pixels,
+               (unsigned long long)(totals->ns / 1000));
+      }
+    }
+    fflush(stdout);
+    _exit(render_data.mismatches ? 1 : 0);
+  }
+  int status;
+  return waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int main(int argc, char **argv) {
+  render_data.out_dir = argc > 1 ? argv[1] : ".";
+  render_data.incremental = malloc(host_frame_buffer_size());
+  render_data.full = malloc(host_frame_buffer_size());
+  if (!render_data.incremental || !render_data.full) {
+    return 1;
+  }
+  const RenderScenario scenarios[] = {
+      {"countdown", prv_scenario_countdown},
+      {"edit", prv_scenario_edit},
+      {"focus", prv_scenario_focus},
+      {"hours", prv_scenario_hours},
+  };
+  int result = 0;
+  for (uint8_t ii = 0; ii < ARRAY_LENGTH(scenarios); ii++) {
+    if (!prv_scenario_run(&scenarios[ii])) {
+      fprintf(stderr, "render: %s failed\n", scenarios[ii].name);
+      result = 1;
+    }
+  }
+  free(render_data.incremental);
+  free(render_data.full);
+  return result;
+}
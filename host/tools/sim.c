@@ -0,0 +1,166 @@
+// @file sim.c
+// @brief Simulates hours of the app in use on the host build
+//
+// Runs the app through a scripted day of launches on the virtual clock:
+// setting two countdowns and closing the app, being woken up for the first
+// expiry, and then staying open for hours while the timers count on. Each
+// launch runs in its own process, so the app starts fresh every time, with
+// the persist store and wakeups carried over. Logs one line per launch of
+// "sim,<launch>,<frames>,<timers fired>,<vibes>,<wakeups>,<allocations>,
+// <heap high water>,<persist writes>,<virtual ms>,<real us>", and exits with
+// an error if a countdown didn't alert or the app leaked memory.
+//
+// @author agent
+// @date October 16, 2026
+
+#include <pebble_host.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define SIM_START_EPOCH_MS 1798761600000ULL //< Midnight UTC on January 1, 2027
+#define SIM_STATE_PATH_SIZE 64
+#define MSEC_IN_SEC 1000
+#define MSEC_IN_MIN (60 * MSEC_IN_SEC)
+#define MSEC_IN_HR (60 * MSEC_IN_MIN)
+
+// The app's entry point, renamed by the Makefile
+int app_main(void);
+
+// A scripted launch of the app
+typedef struct {
+  const char *name;          //< Name of the launch in the log
+  AppLaunchReason reason;    //< Reason the app is launched with
+  HostEventLoop event_loop;  //< What happens while the app is open
+} SimLaunch;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Scripts
+//
+
+// Close the app by pressing back until its window is gone
+static void prv_close(void) {
+  for (uint8_t ii = 0; ii < 8 && host_app_is_running(); ii++) {
+    host_click(BUTTON_ID_BACK, HostClickSingle);
+  }
+}
+
+// Set a countdown on the selected timer from the edit mode it opens in, then start it
+static void prv_countdown_set(uint16_t minutes) {
+  for (uint16_t ii = 0; ii < minutes; ii++) {
+    host_click(BUTTON_ID_UP, HostClickSingle);
+    host_run(200);
+  }
+  // minutes, seconds, then start
+  host_click(BUTTON_ID_SELECT, HostClickSingle);
+  host_click(BUTTON_ID_SELECT, HostClickSingle);
+}
+
+// Set a 10 and a 25 minute countdown on two timers, then close the app
+static void prv_script_set_countdowns(void) {
+  host_run(MSEC_IN_SEC);
+  prv_countdown_set(10);
+  host_run(2 * MSEC_IN_SEC);
+  // switch to the next timer, which is stopped and so opens for editing
+  host_click(BUTTON_ID_DOWN, HostClickSingle);
+  host_click(BUTTON_ID_SELECT, HostClickSingle);
+  prv_countdown_set(25);
+  host_run(2 * MSEC_IN_SEC);
+  prv_close();
+}
+
+// Woken up for the first countdown, stay open until the second one has gone off too
+static void prv_script_wakeup(void) {
+  host_run(20 * MSEC_IN_MIN);
+  prv_close();
+}
+
+// Stay open for hours while both timers count up past their expiry
+static void prv_script_hours_open(void) {
+  host_run(3 * MSEC_IN_HR);
+  // cover the app with a notification, then come back to it
+  host_focus(false);
+  host_run(5 * MSEC_IN_SEC);
+  host_focus(true);
+  host_run(MSEC_IN_MIN);
+  prv_close();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Launching
+//
+
+// Run one launch of the app in a child process, so its static data starts fresh. The child starts
+// from a copy of the SDK state, and passes it back once the app exits
+static bool prv_launch(const SimLaunch *launch, const char *state_path) {
+  fflush(stdout);
+  pid_t pid = fork();
+  if (pid < 0) {
+    return false;
+  }
+  if (pid == 0) {
+    host_launch(launch->reason, launch->event_loop);
+    app_main();
+    bool saved = host_state_save(state_path);
+    fflush(stdout);
+    if (heap_bytes_used()) {
+      fprintf(stderr, "sim: %s leaked %d bytes\n", launch->name, (int)heap_bytes_used());
+      _exit(2);
+    }
+    _exit(saved ? 0 : 1);
+  }
+  int status;
+  return waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+         host_state_load(state_path);
+}
+
+// Log the counters of a launch
+static void prv_log(const char *name, const HostStats *before, uint64_t clock_before,
+                    uint64_t real_before) {
+  const HostStats *after = host_get_stats();
+  printf("sim,%s,%u,%u,%u,%u,%u,%zu,%u,%llu,%llu\n", name, after->frames - before->frames,
+         after->timers_fired - before->timers_fired, after->vibes - before->vibes,
+         after->wakeups - before->wakeups, after->allocations - before->allocations,
+         after->heap_high_water, after->persist_writes - before->persist_writes,
+         (unsigned long long)(host_clock_now() - clock_before),
+         (unsigned long long)((host_time_ns() - real_before) / 1000));
+}
+
+int main(int argc, char **argv) {
+  char state_path[SIM_STATE_PATH_SIZE];
+  snprintf(state_path, sizeof(state_path), "/tmp/pebble-host-sim-%d.state", (int)getpid());
+  host_reset(SIM_START_EPOCH_MS);
+  const SimLaunch launches[] = {
+      {"set_countdowns", APP_LAUNCH_USER, prv_script_set_countdowns},
+      {"wakeup", APP_LAUNCH_WAKEUP, prv_script_wakeup},
+      {"hours_open", APP_LAUNCH_USER, prv_script_hours_open},
+  };
+  int result = 0;
+  for (uint8_t ii = 0; ii < ARRAY_LENGTH(launches) && !result; ii++) {
+    const SimLaunch *launch = &launches[ii];
+    if (launch->reason == APP_LAUNCH_WAKEUP) {
+      // sleep with the app closed until the wakeup it scheduled
+      time_t wakeup_time;
+      if (!host_wakeup_next(&wakeup_time)) {
+        fprintf(stderr, "sim: %s expected a wakeup to be scheduled\n", launch->name);
+        result = 1;
+        break;
+      }
+      host_run((uint64_t)wakeup_time * MSEC_IN_SEC - host_clock_now());
+    }
+    HostStats before = *host_get_stats();
+    uint64_t clock_before = host_clock_now();
+    uint64_t real_before = host_time_ns();
+    if (!prv_launch(launch, state_path)) {
+      fprintf(stderr, "sim: %s failed\n", launch->name);
+      result = 1;
+      break;
+    }
+    prv_log(launch->name, &before, clock_before, real_before);
+    if (launch->reason == APP_LAUNCH_WAKEUP && host_get_stats()->vibes - before.vibes < 2) {
+      fprintf(stderr, "sim: %s expected both countdowns to alert\n", launch->name);
+      result = 1;
+    }
+  }
+  remove(state_path);
+  return result;
+}
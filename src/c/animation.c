@@ -3,7 +3,9 @@
 //
 // Animation framework to animate a pointer's value. Includes automatic
 // detection of multiple animations per pointer, and destroys the oldest one.
-// Animations also auto-destruct when complete
+// Animations also auto-destruct when complete. Animation nodes live in a
+// fixed-size static pool, so no heap memory is used. When the pool is full,
+// the oldest animation is finished immediately to make room for the new one.
 //
 // @author Eric D. Phillips
 // @date September 1, 2015
@@ -13,54 +15,67 @@
 #include "utility.h"
 
 // Animation constants
-#define ANIMATION_TICK_INTERVAL 30 //< Number of milliseconds to pause between animation ticks
+#define ANIMATION_POOL_SIZE 16 //< Maximum number of simultaneously running animations
+
+// Inline storage for any animated value type
+typedef union {
+  GRect grect;   //< Value of a GRect animation
+  int32_t int32; //< Value of an int32 animation
+} AnimationValue;
 
 // Animation pointer type
-typedef struct AnimationNode {
-  void (*step_func)(struct AnimationNode *); //< Function to call when stepping animation
-  void *target;                              //< Pointer to value being animated
-  void *from;                                //< Pointer to value to animate from
-  void *to;                                  //< Pointer to value to animate to
-  uint64_t start_time;                       //< Millisecond epoch of when animation was started
-  uint32_t duration;                         //< Duration of animation in milliseconds
-  uint32_t delay;                            //< Time to wait before animating
-  InterpolationCurve interpolation;          //< The interpolation mode to use with this animation
-  struct AnimationNode *next;                //< Pointer to next node in linked list
-} AnimationNode;
+typedef struct AnimationNode AnimationNode;
 
-// Animation framework data
-static AnimationNode *head_node = NULL;   //< Head node in linked list containing all animations
-static AppTimer *ani_timer = NULL;        //< AppTimer for stepping all animations
-static void (*ani_callback)(void) = NULL; //< Animation update callback
+// Animation step function, given the node and the time of the current frame
+typedef void (*AnimationStepFunction)(AnimationNode *node, uint64_t now);
+
+struct AnimationNode {
+  AnimationStepFunction step_func;  //< Function to call when stepping animation
+  void *target;                     //< Pointer to value being animated
+  AnimationValue from;              //< Value to animate from
+  AnimationValue to;                //< Value to animate to
+  uint64_t start_time;              //< Millisecond epoch of when animation was started
+  uint32_t duration;                //< Duration of animation in milliseconds
+  uint32_t delay;                   //< Time to wait before animating
+  InterpolationCurve interpolation; //< The interpolation mode to use with this animation
+  bool has_from;                    //< If the from value has been captured yet
+  AnimationNode *next;              //< Pointer to next node in linked list or free list
+};
 
-// Functions
-static void prv_animation_timer_start(void);
+// Animation framework data
+static AnimationNode node_pool[ANIMATION_POOL_SIZE]; //< Static storage for all animation nodes
+static AnimationNode *free_node = NULL;              //< Head node in list of unused pool nodes
+static AnimationNode *head_node = NULL;              //< Head node in list of all animations
+static AnimationNode *tail_node = NULL;              //< Tail node in list of all animations
+static bool pool_initialized = false;                //< If the free list has been built yet
+static void (*ani_schedule)(uint32_t delay) = NULL;  //< Callback to schedule the next step
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Private Functions
 //
 
 // Step a GRect animation
-static void prv_animation_step_grect(AnimationNode *node) {
+static void prv_animation_step_grect(AnimationNode *node, uint64_t now) {
   // set from grect on first call, allowing another animation to change the target value
   // while this animation is delayed
-  if (!node->from) {
-    node->from = MALLOC(sizeof(GRect));
-    (*(GRect *)node->from) = (*(GRect *)node->target);
+  if (!node->has_from) {
+    node->from.grect = (*(GRect *)node->target);
+    node->has_from = true;
   }
   // step value
-  GRect from = (*(GRect *)node->from);
-  GRect to = (*(GRect *)node->to);
+  GRect from = node->from.grect;
+  GRect to = node->to.grect;
   uint32_t percent_max = node->duration;
-  uint32_t percent = epoch() - (node->start_time + node->delay);
+  uint32_t percent = now - (node->start_time + node->delay);
+  int32_t progress = interpolation_get_progress(percent, percent_max, node->interpolation);
   (*(GRect *)node->target).origin.x =
-      interpolation_integer(from.origin.x, to.origin.x, percent, percent_max, node->interpolation);
+      interpolation_integer_progress(from.origin.x, to.origin.x, progress);
   (*(GRect *)node->target).origin.y =
-      interpolation_integer(from.origin.y, to.origin.y, percent, percent_max, node->interpolation);
+      interpolation_integer_progress(from.origin.y, to.origin.y, progress);
   (*(GRect *)node->target).size.w =
-      interpolation_integer(from.size.w, to.size.w, percent, percent_max, node->interpolation);
+      interpolation_integer_progress(from.size.w, to.size.w, progress);
   (*(GRect *)node->target).size.h =
-      interpolation_integer(from.size.h, to.size.h, percent, percent_max, node->interpolation);
+      interpolation_integer_progress(from.size.h, to.size.h, progress);
   // continue animation
   if (percent >= percent_max) {
     animation_stop(node->target);
@@ -68,20 +83,20 @@ static void prv_animation_step_grect(AnimationNode *node) {
 }
 
 // Step a int32 animation
-static void prv_animation_step_int32(AnimationNode *node) {
+static void prv_animation_step_int32(AnimationNode *node, uint64_t now) {
   // set from value on first call, allowing another animation to change the target value
   // while this animation is delayed
-  if (!node->from) {
-    node->from = MALLOC(sizeof(int32_t));
-    (*(int32_t *)node->from) = (*(int32_t *)node->target);
+  if (!node->has_from) {
+    node->from.int32 = (*(int32_t *)node->target);
+    node->has_from = true;
   }
   // step value
-  int32_t from = (*(int32_t *)node->from);
-  int32_t to = (*(int32_t *)node->to);
+  int32_t from = node->from.int32;
+  int32_t to = node->to.int32;
   uint32_t percent_max = node->duration;
-  uint32_t percent = epoch() - (node->start_time + node->delay);
-  (*(int32_t *)node->target) =
-      interpolation_integer(from, to, percent, percent_max, node->interpolation);
+  uint32_t percent = now - (node->start_time + node->delay);
+  int32_t progress = interpolation_get_progress(percent, percent_max, node->interpolation);
+  (*(int32_t *)node->target) = interpolation_integer_progress(from, to, progress);
   // continue animation
   if (percent >= percent_max) {
     animation_stop(node->target);
@@ -90,45 +105,106 @@ static void prv_animation_step_int32(AnimationNode *node) {
 
 // Add node to end of linked list
 static void prv_list_add_node(AnimationNode *node) {
+  node->next = NULL;
   if (!head_node) {
-    head_node = node;
+    head_node = tail_node = node;
     return;
   }
-  AnimationNode *cur_node = head_node;
-  while (cur_node->next) {
-    cur_node = cur_node->next;
+  tail_node->next = node;
+  tail_node = node;
+}
+
+// Build the free list from the static node pool
+static void prv_pool_initialize(void) {
+  free_node = NULL;
+  for (uint8_t ii = 0; ii < ANIMATION_POOL_SIZE; ii++) {
+    node_pool[ii].next = free_node;
+    free_node = &node_pool[ii];
   }
-  cur_node->next = node;
+  head_node = tail_node = NULL;
+  pool_initialized = true;
 }
 
-// Animation timer callback
-static void prv_animation_timer_callback(void *data) {
-  ani_timer = NULL;
-  // loop over list and step each animation
-  AnimationNode *cur_node = head_node;
-  while (cur_node) {
-    // save next pointer before stepping, since step may free cur_node via animation_stop()
-    AnimationNode *next_node = cur_node->next;
-    if (epoch() > cur_node->start_time + (uint64_t)cur_node->delay) {
-      (*cur_node->step_func)(cur_node);
-    }
-    cur_node = next_node;
+// Unlink a node from the animation list, given the node before it (or NULL if it is the head)
+static void prv_list_remove_node(AnimationNode *node, AnimationNode *pre_node) {
+  if (pre_node) {
+    pre_node->next = node->next;
+  } else {
+    head_node = node->next;
   }
-  // continue animation
-  if (head_node) {
-    prv_animation_timer_start();
+  if (tail_node == node) {
+    tail_node = pre_node;
+  }
+}
+
+// Return a node to the free list
+static void prv_pool_free_node(AnimationNode *node) {
+  node->next = free_node;
+  free_node = node;
+}
+
+// Finish the oldest animation immediately, jumping its target to the final value
+static void prv_pool_evict_oldest(void) {
+  AnimationNode *node = head_node;
+  if (node->step_func == &prv_animation_step_grect) {
+    (*(GRect *)node->target) = node->to.grect;
+  } else {
+    (*(int32_t *)node->target) = node->to.int32;
   }
-  // raise animation update callback
-  if (ani_callback) {
-    ani_callback();
+  prv_list_remove_node(node, NULL);
+  prv_pool_free_node(node);
+}
+
+// Take a node from the free list, evicting the oldest animation if the pool is exhausted
+static AnimationNode *prv_pool_alloc_node(void) {
+  if (!pool_initialized) {
+    prv_pool_initialize();
+  }
+  if (!free_node) {
+    prv_pool_evict_oldest();
   }
+  AnimationNode *node = free_node;
+  free_node = node->next;
+  return node;
 }
 
-// Start animation timer if not running
-static void prv_animation_timer_start(void) {
-  if (!ani_timer) {
-    ani_timer = app_timer_register(ANIMATION_TICK_INTERVAL, &prv_animation_timer_callback, NULL);
+// Get the number of milliseconds until the next animation frame is needed, which is a full frame
+// interval while any animation is running, otherwise the end of the earliest delay
+static uint32_t prv_animation_next_delay(uint64_t now) {
+  uint32_t next_delay = UINT32_MAX;
+  for (AnimationNode *cur_node = head_node; cur_node; cur_node = cur_node->next) {
+    uint64_t begin_time = cur_node->start_time + (uint64_t)cur_node->delay;
+    if (now > begin_time) {
+      return ANIMATION_TICK_INTERVAL;
+    }
+    // nodes are first stepped once the epoch is strictly after their begin time
+    uint32_t delay = begin_time - now + 1;
+    if (delay < next_delay) {
+      next_delay = delay;
+    }
   }
+  return next_delay;
+}
+
+// Schedule the next step for when the next animation frame is needed
+static void prv_animation_schedule(void) {
+  if (head_node && ani_schedule) {
+    ani_schedule(prv_animation_next_delay(frame_clock_now()));
+  }
+}
+
+// Populate and queue a node taken from the pool
+static void prv_animation_start(AnimationNode *node, void *ptr, uint32_t duration, uint32_t delay,
+                                InterpolationCurve interpolation) {
+  node->target = ptr;
+  node->has_from = false; // assigned on first "step" callback in case of delayed animation
+  node->start_time = frame_clock_now();
+  node->duration = duration;
+  node->delay = delay;
+  node->interpolation = interpolation;
+  prv_list_add_node(node);
+  // schedule the first step
+  prv_animation_schedule();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -138,41 +214,19 @@ static void prv_animation_timer_start(void) {
 // Animate a GRect by its pointer
 void animation_grect_start(GRect *ptr, GRect to, uint32_t duration, uint32_t delay,
                            InterpolationCurve interpolation) {
-  // create and add new node
-  AnimationNode *new_node = (AnimationNode *)MALLOC(sizeof(AnimationNode));
+  AnimationNode *new_node = prv_pool_alloc_node();
   new_node->step_func = &prv_animation_step_grect;
-  new_node->target = ptr;
-  new_node->from = NULL; // assigned on first "step" callback in case of delayed animation
-  new_node->to = MALLOC(sizeof(GRect));
-  (*(GRect *)new_node->to) = to;
-  new_node->start_time = epoch();
-  new_node->duration = duration;
-  new_node->delay = delay;
-  new_node->interpolation = interpolation;
-  new_node->next = NULL;
-  prv_list_add_node(new_node);
-  // start animation timer if not running
-  prv_animation_timer_start();
+  new_node->to.grect = to;
+  prv_animation_start(new_node, ptr, duration, delay, interpolation);
 }
 
 // Animate an integer by its pointer
 void animation_int32_start(int32_t *ptr, int32_t to, uint32_t duration, uint32_t delay,
                            InterpolationCurve interpolation) {
-  // create and add new node
-  AnimationNode *new_node = (AnimationNode *)MALLOC(sizeof(AnimationNode));
+  AnimationNode *new_node = prv_pool_alloc_node();
   new_node->step_func = &prv_animation_step_int32;
-  new_node->target = ptr;
-  new_node->from = NULL; // assigned on first "step" callback in case of delayed animation
-  new_node->to = MALLOC(sizeof(int32_t));
-  (*(int32_t *)new_node->to) = to;
-  new_node->start_time = epoch();
-  new_node->duration = duration;
-  new_node->delay = delay;
-  new_node->interpolation = interpolation;
-  new_node->next = NULL;
-  prv_list_add_node(new_node);
-  // start animation timer if not running
-  prv_animation_timer_start();
+  new_node->to.int32 = to;
+  prv_animation_start(new_node, ptr, duration, delay, interpolation);
 }
 
 // Cancel an animation by its pointer
@@ -181,16 +235,8 @@ void animation_stop(void *ptr) {
   AnimationNode *pre_node = NULL;
   while (cur_node) {
     if (cur_node->target == ptr) {
-      // link surrounding nodes
-      if (pre_node) {
-        pre_node->next = cur_node->next;
-      } else {
-        head_node = cur_node->next;
-      }
-      // destroy node
-      free(cur_node->from);
-      free(cur_node->to);
-      free(cur_node);
+      prv_list_remove_node(cur_node, pre_node);
+      prv_pool_free_node(cur_node);
       return;
     }
     pre_node = cur_node;
@@ -200,23 +246,32 @@ void animation_stop(void *ptr) {
 
 // Cancel all running animations
 void animation_stop_all(void) {
-  // stop timer
-  if (ani_timer) {
-    app_timer_cancel(ani_timer);
-  }
-  // destroy all animations
+  // return all nodes to the pool
+  prv_pool_initialize();
+}
+
+// Check if any animation is running or waiting out its delay
+bool animation_is_running(void) { return head_node != NULL; }
+
+// Step every running animation to the current frame
+bool animation_step_all(void) {
+  uint64_t now = frame_clock_now();
+  // loop over list and step each animation
+  bool stepped = false;
   AnimationNode *cur_node = head_node;
-  AnimationNode *tmp_node = NULL;
   while (cur_node) {
-    // index node
-    tmp_node = cur_node;
-    cur_node = cur_node->next;
-    // destroy node
-    free(tmp_node->from);
-    free(tmp_node->to);
-    free(tmp_node);
+    // save next pointer before stepping, since step may free cur_node via animation_stop()
+    AnimationNode *next_node = cur_node->next;
+    if (now > cur_node->start_time + (uint64_t)cur_node->delay) {
+      (*cur_node->step_func)(cur_node, now);
+      stepped = true;
+    }
+    cur_node = next_node;
   }
+  // continue animation
+  prv_animation_schedule();
+  return stepped;
 }
 
-// Register animation update callback
-void animation_register_update_callback(void *callback) { ani_callback = callback; }
+// Register the callback used to schedule animation steps
+void animation_register_schedule_callback(void *callback) { ani_schedule = callback; }
@@ -3,7 +3,9 @@
 //!
 //! Animation framework to animate a pointer's value. Includes automatic
 //! detection of multiple animations per pointer, and destroys the oldest one.
-//! Animations also auto-destruct when complete
+//! Animations also auto-destruct when complete. Animation nodes live in a
+//! fixed-size static pool, so no heap memory is used. When the pool is full,
+//! the oldest animation is finished immediately to make room for the new one.
 //!
 //! @author Eric D. Phillips
 //! @date September 1, 2015
@@ -13,6 +15,9 @@
 #include "interpolation.h"
 #include <pebble.h>
 
+//! Number of milliseconds between frames of running animations
+#define ANIMATION_TICK_INTERVAL 30
+
 //! Animate a GRect by its pointer
 //! @param prt A pointer to the GRect to animate
 //! @param to The GRect to animate the pointer to
@@ -38,6 +43,15 @@ void animation_stop(void *ptr);
 //! Cancel all running animations
 void animation_stop_all(void);
 
-//! Register animation update callback
-//! @param callback A pointer to the function to call when updating
-void animation_register_update_callback(void *callback);
+//! Check if any animation is running or waiting out its delay
+//! @return True if any animation has not yet finished
+bool animation_is_running(void);
+
+//! Step every running animation to the current frame, then schedule the next step
+//! @return True if any animated value was stepped
+bool animation_step_all(void);
+
+//! Register the callback used to schedule animation steps, which is passed the number of
+//! milliseconds until animation_step_all should next be called
+//! @param callback A pointer to the function to call when scheduling
+void animation_register_schedule_callback(void *callback);
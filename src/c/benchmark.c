@@ -0,0 +1,194 @@
+// @file benchmark.c
+// @brief On-device microbenchmarks for the hot paths
+//
+// Times interpolation, text layout and drawing, animation stepping,
+// formatting and whole frames, and logs one machine-readable line per
+// benchmark. Only compiled in when building with BENCHMARK defined.
+//
+// @author agent
+// @date October 16, 2026
+
+#include "benchmark.h"
+
+#ifdef BENCHMARK
+#include "animation.h"
+#include "drawing.h"
+#include "format.h"
+#include "interpolation.h"
+#include "text_render.h"
+#include "utility.h"
+#ifdef PBL_HOST
+#include <pebble_host.h>
+#endif
+
+#define BENCHMARK_CURVE_COUNT (CurveSinEaseInOut + 1)
+#define BENCHMARK_MAX_NODES 16
+
+// Sink for benchmark results, so the compiler can't remove the work being timed
+static volatile int32_t benchmark_sink;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+//
+
+// Get a timestamp in microseconds, from the real clock on the host build, and from the epoch on
+// the watch, which only has millisecond resolution
+static uint64_t prv_benchmark_now_us(void) {
+#ifdef PBL_HOST
+  return host_time_ns() / 1000;
+#else
+  return epoch() * 1000;
+#endif
+}
+
+// Log a benchmark result, with the variant appended to the name unless it is negative
+static void prv_benchmark_log(const char *name, int variant, uint32_t iterations,
+                              uint64_t start) {
+  int elapsed_us = (int)(prv_benchmark_now_us() - start);
+  if (variant < 0) {
+    APP_LOG(APP_LOG_LEVEL_INFO, "bench,%s,%d,%d", name, (int)iterations, elapsed_us);
+  } else {
+    APP_LOG(APP_LOG_LEVEL_INFO, "bench,%s%d,%d,%d", name, variant, (int)iterations, elapsed_us);
+  }
+}
+
+// Time eased interpolation for every curve
+static void prv_benchmark_interpolation(void) {
+  const uint32_t ITERATIONS = 20000;
+  for (uint8_t curve = 0; curve < BENCHMARK_CURVE_COUNT; curve++) {
+    int32_t sum = 0;
+    uint64_t start = prv_benchmark_now_us();
+    for (uint32_t ii = 0; ii < ITERATIONS; ii++) {
+      int32_t progress = interpolation_get_progress(ii % 1024, 1023, curve);
+      sum += interpolation_integer_progress(0, 1000, progress);
+    }
+    benchmark_sink = sum;
+    prv_benchmark_log("interpolation_curve", curve, ITERATIONS, start);
+  }
+}
+
+// Time text layout for a short and long time string
+static void prv_benchmark_text_layout(void) {
+  const uint32_t ITERATIONS = 200;
+  char *buffs[] = {"0:05", "12:34:56"};
+  for (uint8_t ii = 0; ii < ARRAY_LENGTH(buffs); ii++) {
+    int32_t sum = 0;
+    uint64_t start = prv_benchmark_now_us();
+    for (uint32_t jj = 0; jj < ITERATIONS; jj++) {
+      sum += text_render_get_max_font_size(buffs[ii], GRect(0, 0, 100 + jj % 50, 60));
+    }
+    benchmark_sink = sum;
+    prv_benchmark_log("text_max_font_size_len", strlen(buffs[ii]), ITERATIONS, start);
+  }
+}
+
+// Time stepping an increasing number of live animations
+static void prv_benchmark_animation(void) {
+  const uint32_t ITERATIONS = 500;
+  static int32_t targets[BENCHMARK_MAX_NODES];
+  for (uint8_t count = 1; count <= BENCHMARK_MAX_NODES; count *= 2) {
+    for (uint8_t ii = 0; ii < count; ii++) {
+      animation_int32_start(&targets[ii], 1000, 60000, 0, CurveSinEaseInOut);
+    }
+    // animations are only stepped once the clock has passed their start time
+    psleep(2);
+    uint64_t start = prv_benchmark_now_us();
+    for (uint32_t ii = 0; ii < ITERATIONS; ii++) {
+      frame_clock_begin();
+      benchmark_sink = animation_step_all();
+      frame_clock_end();
+    }
+    prv_benchmark_log("animation_step_nodes", count, ITERATIONS, start);
+    animation_stop_all();
+  }
+}
+
+// Time the formatter against the snprintf based formatting it replaced
+static void prv_benchmark_format(void) {
+  const uint32_t ITERATIONS = 10000;
+  char fields[FORMAT_FIELD_COUNT][FORMAT_FIELD_SIZE];
+  int32_t sum = 0;
+  // table driven formatter
+  uint64_t start = prv_benchmark_now_us();
+  for (uint32_t ii = 0; ii < ITERATIONS; ii++) {
+    format_time_fields(fields, ii % 100, ii % 60, ii % 59, ii & 1);
+    sum += fields[4][1];
+  }
+  benchmark_sink = sum;
+  prv_benchmark_log("format_table", -1, ITERATIONS, start);
+  // previous snprintf based formatting
+  start = prv_benchmark_now_us();
+  for (uint32_t ii = 0; ii < ITERATIONS; ii++) {
+    uint16_t hr = ii % 100, min = ii % 60, sec = ii % 59;
+    bool edit_mode = ii & 1;
+    fields[0][0] = '\0';
+    if (hr) {
+      snprintf(fields[0], sizeof(fields[0]), edit_mode ? "%02d" : "%d", hr);
+    }
+    snprintf(fields[1], sizeof(fields[1]), "%s", hr && !edit_mode ? ":" : "\0");
+    snprintf(fields[2], sizeof(fields[2]), (hr || edit_mode) ? "%02d" : "%d", min);
+    snprintf(fields[3], sizeof(fields[3]), "%s", edit_mode ? "\0" : ":");
+    snprintf(fields[4], sizeof(fields[4]), "%02d", sec);
+    sum += fields[4][1];
+  }
+  benchmark_sink = sum;
+  prv_benchmark_log("format_snprintf", -1, ITERATIONS, start);
+}
+
+// Time drawing already measured time text at several heights, as each frame draws it
+static void prv_benchmark_text_draw(GContext *ctx) {
+  const uint32_t ITERATIONS = 100;
+  char text[] = "12:34";
+  int16_t width = text_render_get_unscaled_width(text);
+  const int16_t heights[] = {20, 40, 60};
+  for (uint8_t ii = 0; ii < ARRAY_LENGTH(heights); ii++) {
+    GRect bounds = GRect(0, 0, heights[ii] * 4, heights[ii]);
+    uint64_t start = prv_benchmark_now_us();
+    for (uint32_t jj = 0; jj < ITERATIONS; jj++) {
+      frame_clock_begin();
+      text_render_draw_measured_text(ctx, text, width, bounds);
+      frame_clock_end();
+    }
+    prv_benchmark_log("text_draw_height", heights[ii], ITERATIONS, start);
+  }
+}
+
+// Time whole frames, both drawn in full and drawn again with nothing changed
+static void prv_benchmark_frame(Layer *layer, GContext *ctx) {
+  const uint32_t ITERATIONS = 50;
+  uint64_t start = prv_benchmark_now_us();
+  for (uint32_t ii = 0; ii < ITERATIONS; ii++) {
+    drawing_invalidate_frame();
+    drawing_update();
+    drawing_render(layer, ctx);
+  }
+  prv_benchmark_log("frame_full", -1, ITERATIONS, start);
+  start = prv_benchmark_now_us();
+  for (uint32_t ii = 0; ii < ITERATIONS; ii++) {
+    drawing_update();
+    drawing_render(layer, ctx);
+  }
+  prv_benchmark_log("frame_steady", -1, ITERATIONS, start);
+  // the benchmarks drew over the framebuffer, so the next frame draws everything
+  drawing_invalidate_frame();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// API Functions
+//
+
+// Run every benchmark which doesn't draw and log the results
+void benchmark_run(void) {
+  prv_benchmark_interpolation();
+  prv_benchmark_text_layout();
+  prv_benchmark_animation();
+  prv_benchmark_format();
+}
+
+// Run every benchmark which draws and log the results
+void benchmark_run_render(Layer *layer, GContext *ctx) {
+  prv_benchmark_text_draw(ctx);
+  prv_benchmark_frame(layer, ctx);
+}
+
+#endif
@@ -0,0 +1,25 @@
+//! @file benchmark.h
+//! @brief On-device microbenchmarks for the hot paths
+//!
+//! Times interpolation, text layout and drawing, animation stepping,
+//! formatting and whole frames, and logs one machine-readable line per
+//! benchmark. Only compiled in when building with BENCHMARK defined.
+//!
+//! @author agent
+//! @date October 16, 2026
+
+#pragma once
+#include <pebble.h>
+
+#ifdef BENCHMARK
+//! Run every benchmark which doesn't draw and log the results, each as
+//! "bench,<name>,<iterations>,<total us>". Times are taken from the epoch on the watch, so only
+//! have millisecond resolution there
+void benchmark_run(void);
+
+//! Run every benchmark which draws and log the results like benchmark_run, from a layer's update
+//! procedure once drawing is initialized. The next frame then draws everything
+//! @param layer The layer being rendered onto
+//! @param ctx The layer's drawing context
+void benchmark_run_render(Layer *layer, GContext *ctx);
+#endif
@@ -8,7 +8,10 @@
 // @bugs No known bugs
 
 #include "animation.h"
+#include "format.h"
 #include "main.h"
+#include "profile.h"
+#include "refresh.h"
 #include "text_render.h"
 #include "timer.h"
 #include "utility.h"
@@ -40,7 +43,7 @@
   GRect(-MAIN_TEXT_CIRCLE_RADIUS_EDIT, -MAIN_TEXT_CIRCLE_RADIUS_EDIT / 2,                          \
         MAIN_TEXT_CIRCLE_RADIUS_EDIT * 2, MAIN_TEXT_CIRCLE_RADIUS_EDIT)
 // Main Text
-#define TEXT_FIELD_COUNT 5
+#define TEXT_FIELD_COUNT FORMAT_FIELD_COUNT
 #define TEXT_FIELD_EDIT_SPACING scl_y(42)
 #define TEXT_FIELD_ANI_DURATION 140
 // Focus Layer
@@ -60,6 +63,9 @@
 #define HEADER_Y_OFFSET scl_y(53)
 #define FOOTER_Y_OFFSET scl_y(160)
 #endif
+#define HEADER_TEXT_SIZE (sizeof("Chrono ") - 1 + FORMAT_FIELD_SIZE)
+// Background Snapshot
+#define BACKGROUND_SNAPSHOT_HEAP_RESERVE 8192
 // Fonts
 typedef enum {
   ScalableFontLabel,
@@ -73,17 +79,66 @@ typedef struct {
   uint8_t min_digits;       //< The number of digits used by the minutes
 } DrawState;
 
+// Formatted and measured time, rebuilt only when the displayed time or control mode changes
+typedef struct {
+  bool valid;                                       //< If the model has been built yet
+  ControlMode control_mode;                         //< The control mode the model was built for
+  uint16_t hr;                                      //< The hours the model was built for
+  uint16_t min;                                     //< The minutes the model was built for
+  uint16_t sec;                                     //< The seconds the model was built for
+  char fields[TEXT_FIELD_COUNT][FORMAT_FIELD_SIZE]; //< The text of each field (hr : min : sec)
+  int16_t widths[TEXT_FIELD_COUNT];                 //< The unscaled width of each field
+  int16_t font_size;                                //< The largest font size fitting all fields
+} TimeDisplayModel;
+
+// Footer end time text, rebuilt only on the minute or when the timer or control mode changes
+typedef struct {
+  bool valid;                   //< If the text is up to date
+  ControlMode control_mode;     //< The control mode the text was built for
+  uint32_t timer_revision;      //< The timer revision the text was built for
+  char text[FORMAT_FIELD_SIZE]; //< The formatted end time
+} FooterModel;
+
+// Half widths of the center circle on a row, or -1 if the circle does not reach the row
+typedef struct {
+  int16_t hole; //< Half width of the hole the ring is drawn around
+  int16_t edge; //< Half width of the band under the anti-aliased edge of the circle
+} RingRowWidths;
+
+// Spans of a row which are in the ring color, each [start, end) and empty if start >= end
+typedef struct {
+  int16_t x[2][2]; //< The start and end column of each span
+} RingRowSpans;
+
+// Copy of the framebuffer holding the ring and center circle, without anything drawn over them
+typedef struct {
+  uint8_t *data;  //< The copied framebuffer rows, NULL if there is no snapshot
+  int32_t angle;  //< The progress ring angle drawn in the copy
+  bool valid;     //< If the copy holds a completely drawn ring and center circle
+  bool attempted; //< If allocating the copy has been attempted, even if it failed
+} BackgroundSnapshot;
+
 // Main data
 static struct {
-  Layer *layer;                        //< The main layer being drawn on, used to force a refresh
-  int32_t progress_angle;              //< The current angle of the progress ring
-  DrawState draw_state;                //< An arbitrary description of the main drawing state
-  GRect text_fields[TEXT_FIELD_COUNT]; //< The number of text fields (hr : min : sec)
-  GRect focus_field;                   //< The selection field layer
-  GColor fore_color;                   //< Color of text
-  GColor mid_color;                    //< Color of center
-  GColor ring_color;                   //< Color of ring
-  GColor back_color;                   //< Color behind ring
+  Layer *layer;                         //< The main layer being drawn on
+  int32_t progress_angle;               //< The current angle of the progress ring
+  DrawState draw_state;                 //< An arbitrary description of the main drawing state
+  GRect text_fields[TEXT_FIELD_COUNT];  //< The number of text fields (hr : min : sec)
+  GRect focus_field;                    //< The selection field layer
+  TimeDisplayModel time_model;          //< The formatted and measured time being displayed
+  GFont custom_font;                    //< The custom footer font, unloaded when terminating
+  FooterModel footer_model;             //< The formatted footer end time being displayed
+  GColor fore_color;                    //< Color of text
+  GColor mid_color;                     //< Color of center
+  GColor ring_color;                    //< Color of ring
+  GColor back_color;                    //< Color behind ring
+  int32_t drawn_angle;                  //< The progress ring angle currently in the framebuffer
+  bool frame_valid;                     //< If the framebuffer still holds the last drawn frame
+  bool animating;                       //< If an animation was running when last drawn
+  char drawn_header[HEADER_TEXT_SIZE];  //< The header text currently in the framebuffer
+  char drawn_footer[FORMAT_FIELD_SIZE]; //< The footer text currently in the framebuffer
+  RingRowWidths *ring_rows;             //< Widths of the center circle on each row
+  BackgroundSnapshot background;        //< Copy of the drawn ring and center circle
 } drawing_data;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -136,6 +191,14 @@ static void prv_render_focus_layer(GContext *ctx) {
 // Sub Texts
 //
 
+// Build the header text, numbered by which timer is selected
+static void prv_header_text_build(char *buff) {
+  const char *label = timer_get_snapshot()->chrono ? "Chrono " : "Timer ";
+  uint8_t length = strlen(label);
+  memcpy(buff, label, length);
+  format_uint(buff + length, timer_get_selected() + 1, 1);
+}
+
 // Draw header text
 static void prv_render_header_text(GContext *ctx, GRect bounds) {
   // calculate bounds
@@ -145,14 +208,31 @@ static void prv_render_header_text(GContext *ctx, GRect bounds) {
   bounds.size.w = CIRCLE_RADIUS * 2;
   bounds.size.h = CIRCLE_RADIUS / 2;
   // draw text
-  char *buff;
-  if (timer_is_chrono()) {
-    buff = "Chrono";
-  } else {
-    buff = "Timer";
+  graphics_draw_text(ctx, drawing_data.drawn_header, scl_get_font(ScalableFontLabel), bounds,
+                     GTextOverflowModeFill, GTextAlignmentCenter, NULL);
+}
+
+// Rebuild the footer text if it was invalidated or the timer or control mode changed
+static void prv_footer_model_update(void) {
+  FooterModel *model = &drawing_data.footer_model;
+  uint32_t timer_revision = timer_get_revision();
+  ControlMode control_mode = main_get_control_mode();
+  if (model->valid && model->timer_revision == timer_revision &&
+      model->control_mode == control_mode) {
+    return;
+  }
+  model->valid = true;
+  model->timer_revision = timer_revision;
+  model->control_mode = control_mode;
+  // in timer mode, get time
+  time_t end_time = frame_clock_now() / MSEC_IN_SEC;
+  const TimerSnapshot *snapshot = timer_get_snapshot();
+  if (control_mode != ControlModeCounting && !snapshot->chrono) {
+    end_time += (snapshot->hr * MIN_IN_HR + snapshot->min) * SEC_IN_MIN + snapshot->sec;
   }
-  graphics_draw_text(ctx, buff, scl_get_font(ScalableFontLabel), bounds, GTextOverflowModeFill,
-                     GTextAlignmentCenter, NULL);
+  // format to readable time
+  struct tm end_tm = *localtime(&end_time);
+  format_clock_time(model->text, &end_tm, clock_is_24h_style());
 }
 
 // Draw footer text
@@ -163,57 +243,64 @@ static void prv_render_footer_text(GContext *ctx, GRect bounds) {
   bounds.origin.y += FOOTER_Y_OFFSET;
   bounds.size.w = CIRCLE_RADIUS * 2;
   bounds.size.h = CIRCLE_RADIUS - FOOTER_Y_OFFSET;
-  // calculate text
-  char buff[10];
-  // in timer mode, get time
-  time_t end_time = epoch() / MSEC_IN_SEC;
-  if (main_get_control_mode() != ControlModeCounting && !timer_is_chrono()) {
-    end_time += timer_get_value_ms() / MSEC_IN_SEC;
-  }
-  // format to readable time
-  struct tm end_tm = *localtime(&end_time);
-  strftime(buff, sizeof(buff), clock_is_24h_style() ? "%H:%M" : "%I:%M", &end_tm);
-  if (buff[0] == '0') { // Strip leading zero
-    for (uint8_t ii = 1; ii < ARRAY_LENGTH(buff); ii++) {
-      buff[ii - 1] = buff[ii];
-    }
-  }
   // draw text
-  graphics_draw_text(ctx, buff, scl_get_font(ScalableFontTime), bounds, GTextOverflowModeFill,
-                     GTextAlignmentCenter, NULL);
+  graphics_draw_text(ctx, drawing_data.drawn_footer, scl_get_font(ScalableFontTime), bounds,
+                     GTextOverflowModeFill, GTextAlignmentCenter, NULL);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Main Text
 //
 
+// Rebuild the time display model if the displayed time or control mode changed
+static void prv_time_display_model_update(void) {
+  TimeDisplayModel *model = &drawing_data.time_model;
+  // check if the displayed time has changed
+  const TimerSnapshot *snapshot = timer_get_snapshot();
+  uint16_t hr = snapshot->hr, min = snapshot->min, sec = snapshot->sec;
+  ControlMode control_mode = main_get_control_mode();
+  if (model->valid && model->hr == hr && model->min == min && model->sec == sec &&
+      model->control_mode == control_mode) {
+    return;
+  }
+  model->valid = true;
+  model->hr = hr;
+  model->min = min;
+  model->sec = sec;
+  model->control_mode = control_mode;
+  // convert to strings
+  bool edit_mode = control_mode != ControlModeCounting;
+  format_time_fields(model->fields, hr, min, sec, edit_mode);
+  // measure each field and the maximum font size of all of them together
+  char tot_buff[TEXT_FIELD_COUNT * FORMAT_FIELD_SIZE];
+  char *tot_ptr = tot_buff;
+  for (uint8_t ii = 0; ii < TEXT_FIELD_COUNT; ii++) {
+    for (char *field_ptr = model->fields[ii]; *field_ptr; field_ptr++) {
+      *tot_ptr++ = *field_ptr;
+    }
+  }
+  *tot_ptr = '\0';
+  model->font_size =
+      text_render_get_max_font_size(tot_buff, edit_mode ? MAIN_TEXT_BOUNDS_EDIT : MAIN_TEXT_BOUNDS);
+  for (uint8_t ii = 0; ii < TEXT_FIELD_COUNT; ii++) {
+    model->widths[ii] = text_render_get_unscaled_width(model->fields[ii]);
+  }
+}
+
 // Update main text drawing state
 static void prv_main_text_update_state(Layer *layer) {
   // get properties
   GRect bounds = layer_get_bounds(layer);
   bool edit_mode = main_get_control_mode() != ControlModeCounting;
-  // calculate time parts
-  uint16_t hr, min, sec;
-  timer_get_time_parts(&hr, &min, &sec);
-  // convert to strings
-  char buff[TEXT_FIELD_COUNT][6] = {{'\0'}};
-  if (hr) {
-    snprintf(buff[0], sizeof(buff[0]), edit_mode ? "%02d" : "%d", hr);
-  }
-  snprintf(buff[1], sizeof(buff[1]), "%s", hr && !edit_mode ? ":" : "\0");
-  snprintf(buff[2], sizeof(buff[2]), (hr || edit_mode) ? "%02d" : "%d", min);
-  snprintf(buff[3], sizeof(buff[3]), "%s", edit_mode ? "\0" : ":");
-  snprintf(buff[4], sizeof(buff[4]), "%02d", sec);
-  // calculate new sizes for all text elements
-  char tot_buff[26];
-  snprintf(tot_buff, sizeof(tot_buff), "%s%s%s%s%s", buff[0], buff[1], buff[2], buff[3], buff[4]);
-  int16_t font_size =
-      text_render_get_max_font_size(tot_buff, edit_mode ? MAIN_TEXT_BOUNDS_EDIT : MAIN_TEXT_BOUNDS);
+  TimeDisplayModel *model = &drawing_data.time_model;
+  prv_time_display_model_update();
+  // the font sizes are about to change, so drop all glyphs scaled for the old layout
+  text_render_invalidate_cache();
   // calculate new size for each text element
   GRect total_bounds = GRectZero;
   GRect field_bounds[TEXT_FIELD_COUNT];
   for (uint8_t ii = 0; ii < TEXT_FIELD_COUNT; ii++) {
-    field_bounds[ii] = text_render_get_content_bounds(buff[ii], font_size);
+    field_bounds[ii] = text_render_get_content_bounds(model->fields[ii], model->font_size);
     // if in edit mode and some fields have content and this one is '\0', then pad it
     if (edit_mode && total_bounds.size.w && field_bounds[ii].size.w == 0) {
       field_bounds[ii].size.w = TEXT_FIELD_EDIT_SPACING;
@@ -241,36 +328,26 @@ static void prv_main_text_update_state(Layer *layer) {
 
 // Draw main text onto drawing context
 static void prv_render_main_text(GContext *ctx, GRect bounds) {
-  // get time parts
-  uint16_t hr, min, sec;
-  timer_get_time_parts(&hr, &min, &sec);
-  // convert to strings
-  bool edit_mode = main_get_control_mode() != ControlModeCounting;
-  char buff[TEXT_FIELD_COUNT][6] = {{'\0'}};
-  if (hr) {
-    snprintf(buff[0], sizeof(buff[0]), edit_mode ? "%02d" : "%d", hr);
-  }
-  snprintf(buff[1], sizeof(buff[1]), "%s", hr && !edit_mode ? ":" : "\0");
-  snprintf(buff[2], sizeof(buff[2]), (hr || edit_mode) ? "%02d" : "%d", min);
-  snprintf(buff[3], sizeof(buff[3]), "%s", edit_mode ? "\0" : ":");
-  snprintf(buff[4], sizeof(buff[4]), "%02d", sec);
+  // get the formatted and measured time
+  TimeDisplayModel *model = &drawing_data.time_model;
+  prv_time_display_model_update();
   // draw the main text elements in their respective bounds
   for (uint8_t ii = 0; ii < TEXT_FIELD_COUNT; ii++) {
-    text_render_draw_scalable_text(ctx, buff[ii], drawing_data.text_fields[ii]);
+    text_render_draw_measured_text(ctx, model->fields[ii], model->widths[ii],
+                                   drawing_data.text_fields[ii]);
   }
 }
 
-// Animation update callback
-static void prv_animation_update_callback(void) {
-  // refresh
-  layer_mark_dirty(drawing_data.layer);
+// Animation schedule callback
+static void prv_animation_schedule_callback(uint32_t delay) {
+  refresh_schedule(RefreshSourceAnimation, delay);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Progress Ring
 //
 
-// Draw progress ring
+// Draw progress ring, covering only the annulus outside of the center circle
 static void prv_render_progress_ring(GContext *ctx, GRect bounds) {
   const int16_t PADDING = 1;
   // calculate ring bounds size
@@ -279,19 +356,266 @@ static void prv_render_progress_ring(GContext *ctx, GRect bounds) {
   bounds.origin.x += bounds.size.w / 2 - radius;
   bounds.origin.y += bounds.size.h / 2 - radius;
   bounds.size.w = bounds.size.h = radius * 2;
-  // draw ring on context
-  int32_t angle_1 = drawing_data.progress_angle;
-  int32_t angle_2 = TRIG_MAX_ANGLE;
+  // overlap the center circle by a pixel, so its anti-aliased edge blends with the ring
+  int16_t inset = radius - CIRCLE_RADIUS + 1;
+  int32_t angle = drawing_data.progress_angle;
+#ifdef PBL_COLOR
+  // the ring color is only drawn behind the whole ring on B/W, where it is a dithered fill
+  graphics_context_set_fill_color(ctx, drawing_data.ring_color);
+  graphics_fill_radial(ctx, bounds, GOvalScaleModeFillCircle, inset, 0, angle);
+#endif
   graphics_context_set_fill_color(ctx, drawing_data.back_color);
-  graphics_fill_radial(ctx, bounds, GOvalScaleModeFillCircle, radius, angle_1, angle_2);
+  graphics_fill_radial(ctx, bounds, GOvalScaleModeFillCircle, inset, angle, TRIG_MAX_ANGLE);
+}
+
+// Get the half width of a circle on a row, or -1 if the circle does not reach the row
+static int16_t prv_circle_row_half_width(int32_t radius, int32_t dy) {
+  int32_t remainder = radius * radius - dy * dy;
+  int16_t width = -1;
+  while (remainder >= 0 && (width + 1) * (width + 1) <= remainder) {
+    width++;
+  }
+  return width;
+}
+
+// Build the table of the center circle's width on each row, which the ring spans skip over
+static void prv_ring_span_table_create(GRect bounds) {
+  int16_t center_y = grect_center_point(&bounds).y;
+  drawing_data.ring_rows = MALLOC(bounds.size.h * sizeof(RingRowWidths));
+  for (int16_t y = 0; y < bounds.size.h; y++) {
+    // cut out a pixel less than the circle, so its anti-aliased edge blends with the ring
+    drawing_data.ring_rows[y].hole = prv_circle_row_half_width(CIRCLE_RADIUS - 1, y - center_y);
+    drawing_data.ring_rows[y].edge = prv_circle_row_half_width(CIRCLE_RADIUS + 1, y - center_y);
+  }
+}
+
+// Fill columns [x_0, x_1) of a 1 bit framebuffer row with a repeating 8 pixel pattern
+static void prv_ring_row_fill_bits(uint8_t *row, int16_t x_0, int16_t x_1, uint8_t pattern) {
+  for (; x_0 < x_1 && x_0 % 8; x_0++) {
+    uint8_t mask = 1 << (x_0 % 8);
+    row[x_0 / 8] = (row[x_0 / 8] & ~mask) | (pattern & mask);
+  }
+  int16_t whole_bytes = (x_1 - x_0) / 8;
+  memset(row + x_0 / 8, pattern, whole_bytes);
+  for (x_0 += whole_bytes * 8; x_0 < x_1; x_0++) {
+    uint8_t mask = 1 << (x_0 % 8);
+    row[x_0 / 8] = (row[x_0 / 8] & ~mask) | (pattern & mask);
+  }
+}
+
+#ifdef PROFILE_RENDER
+// Count the pixels in columns [x_0, x_1) of a framebuffer row which already have the value
+static uint32_t prv_ring_row_count_unchanged(GBitmapDataRowInfo *row_info, bool bw, int16_t x_0,
+                                             int16_t x_1, uint8_t value) {
+  uint32_t unchanged = 0;
+  for (int16_t x = x_0; x < x_1; x++) {
+    if (bw) {
+      unchanged += !((row_info->data[x / 8] ^ value) & (1 << (x % 8)));
+    } else {
+      unchanged += row_info->data[x] == value;
+    }
+  }
+  return unchanged;
+}
+#endif
+
+// Fill columns [x_0, x_1) of a framebuffer row, skipping the center circle and clipping to the
+// row's visible columns
+static void prv_ring_row_fill(GBitmapDataRowInfo *row_info, bool bw, int16_t x_0, int16_t x_1,
+                              int16_t hole_x_0, int16_t hole_x_1, uint8_t value) {
+  if (x_0 < row_info->min_x) {
+    x_0 = row_info->min_x;
+  }
+  if (x_1 > row_info->max_x + 1) {
+    x_1 = row_info->max_x + 1;
+  }
+  // split around the hole, which is empty if hole_x_0 >= hole_x_1
+  int16_t spans[2][2] = {{x_0, x_1 < hole_x_0 ? x_1 : hole_x_0},
+                         {x_0 > hole_x_1 ? x_0 : hole_x_1, x_1}};
+  if (hole_x_0 >= hole_x_1) {
+    spans[0][1] = x_1;
+    spans[1][0] = x_1;
+  }
+  for (uint8_t ii = 0; ii < 2; ii++) {
+    if (spans[ii][0] >= spans[ii][1]) {
+      continue;
+    }
+#ifdef PROFILE_RENDER
+    PROFILE_PIXELS(spans[ii][1] - spans[ii][0],
+                   prv_ring_row_count_unchanged(row_info, bw, spans[ii][0], spans[ii][1], value));
+#endif
+    if (bw) {
+      prv_ring_row_fill_bits(row_info->data, spans[ii][0], spans[ii][1], value);
+    } else {
+      memset(row_info->data + spans[ii][0], value, spans[ii][1] - spans[ii][0]);
+    }
+  }
+}
+
+// Get the column where the ray at an angle crosses a row, clamped to [min_x, max_x]
+static int16_t prv_ring_ray_column(int16_t center_x, int32_t dy, int32_t sin, int32_t cos,
+                                   int16_t min_x, int16_t max_x) {
+  // the ray is (sin, -cos), so it crosses the row at dx = dy * sin / -cos
+  int32_t x = center_x + dy * sin / -cos;
+  return x < min_x ? min_x : (x > max_x ? max_x : x);
+}
+
+// Get the spans of a row which are before an angle, and so in the ring color, given the sine and
+// cosine of the angle
+static RingRowSpans prv_ring_row_spans(int32_t angle, int32_t sin, int32_t cos, int32_t dy,
+                                       int16_t center_x, int16_t width) {
+  // the angle of each pixel increases clockwise from the top, so the pixels before the angle
+  // are at most two spans, split where the ray at that angle crosses the row
+  RingRowSpans spans = {{{width, width}, {width, width}}};
+  if (dy >= 0) {
+    // below the center angles fall from 3/4 to 1/4 of a turn going right
+    if (angle >= TRIG_MAX_ANGLE * 3 / 4) {
+      spans.x[0][0] = 0;
+    } else if (angle > TRIG_MAX_ANGLE / 4) {
+      spans.x[0][0] = prv_ring_ray_column(center_x, dy, sin, cos, 0, width);
+    }
+  } else {
+    // above the center angles rise from 3/4 of a turn to a full turn left of the center, then
+    // from 0 to 1/4 of a turn right of the center
+    spans.x[0][0] = 0;
+    spans.x[0][1] = 0;
+    if (angle > TRIG_MAX_ANGLE * 3 / 4) {
+      spans.x[0][1] = prv_ring_ray_column(center_x, dy, sin, cos, 0, center_x);
+    }
+    spans.x[1][0] = center_x;
+    if (angle < TRIG_MAX_ANGLE / 4) {
+      spans.x[1][1] = prv_ring_ray_column(center_x, dy, sin, cos, center_x, width);
+    }
+  }
+  return spans;
+}
+
+// Check if a column is in the spans of a row
+static bool prv_ring_row_spans_contain(const RingRowSpans *spans, int16_t x) {
+  return (x >= spans->x[0][0] && x < spans->x[0][1]) ||
+         (x >= spans->x[1][0] && x < spans->x[1][1]);
+}
+
+// Draw the progress ring straight into the framebuffer a row of spans at a time, using the
+// precomputed center circle widths, false if the framebuffer could not be captured
+// When not drawing the full ring, only the wedge swept since the drawn angle is drawn, along with
+// the band under the center circle's edge, which the circle blends with again
+static bool prv_render_progress_ring_spans(GContext *ctx, GRect bounds, bool full) {
+  if (!drawing_data.ring_rows) {
+    return false;
+  }
+  GBitmap *frame_buffer = graphics_capture_frame_buffer(ctx);
+  if (!frame_buffer) {
+    return false;
+  }
+  bool bw = gbitmap_get_format(frame_buffer) == GBitmapFormat1Bit;
+  GPoint center = grect_center_point(&bounds);
+  int16_t width = bounds.size.w;
+  int32_t angle = drawing_data.progress_angle;
+  int32_t sin = sin_lookup(angle);
+  int32_t cos = cos_lookup(angle);
+  int32_t drawn_angle = drawing_data.drawn_angle;
+  int32_t drawn_sin = sin_lookup(drawn_angle);
+  int32_t drawn_cos = cos_lookup(drawn_angle);
+  // the layer fills the window, so layer rows and columns are framebuffer rows and columns
+  for (int16_t y = 0; y < bounds.size.h; y++) {
+    int32_t dy = y - center.y;
+    RingRowWidths widths = drawing_data.ring_rows[y];
+    RingRowSpans spans = prv_ring_row_spans(angle, sin, cos, dy, center.x, width);
+    RingRowSpans drawn_spans =
+        prv_ring_row_spans(drawn_angle, drawn_sin, drawn_cos, dy, center.x, width);
+    bool spans_changed = memcmp(&spans, &drawn_spans, sizeof(RingRowSpans)) != 0;
+    if (!full && !spans_changed && widths.edge < 0) {
+      continue;
+    }
+    // cut the row at every span and edge band boundary, then draw each piece that changed
+    int16_t hole_x_0 = center.x - widths.hole;
+    int16_t hole_x_1 = center.x + widths.hole + 1;
+    int16_t edge_x_0 = center.x - widths.edge;
+    int16_t edge_x_1 = center.x + widths.edge + 1;
+    int16_t cuts[] = {0,
+                      width,
+                      spans.x[0][0],
+                      spans.x[0][1],
+                      spans.x[1][0],
+                      spans.x[1][1],
+                      drawn_spans.x[0][0],
+                      drawn_spans.x[0][1],
+                      drawn_spans.x[1][0],
+                      drawn_spans.x[1][1],
+                      edge_x_0,
+                      hole_x_0,
+                      hole_x_1,
+                      edge_x_1};
+    const uint8_t cut_count = ARRAY_LENGTH(cuts);
+    for (uint8_t ii = 1; ii < cut_count; ii++) {
+      for (uint8_t jj = ii; jj > 0 && cuts[jj - 1] > cuts[jj]; jj--) {
+        int16_t cut = cuts[jj];
+        cuts[jj] = cuts[jj - 1];
+        cuts[jj - 1] = cut;
+      }
+    }
+    GBitmapDataRowInfo row_info = gbitmap_get_data_row_info(frame_buffer, y);
+#ifdef PBL_BW
+    // dither the ring color to grey, matching graphics_fill_rect_grey
+    uint8_t ring = y % 2 ? 0b10101010 : 0b01010101;
+    uint8_t back = gcolor_equal(drawing_data.back_color, GColorWhite) ? 0xFF : 0x00;
+#else
+    uint8_t ring = drawing_data.ring_color.argb;
+    uint8_t back = drawing_data.back_color.argb;
+#endif
+    for (uint8_t ii = 0; ii + 1 < cut_count; ii++) {
+      int16_t x_0 = cuts[ii];
+      int16_t x_1 = cuts[ii + 1];
+      if (x_0 >= x_1 || x_0 < 0 || x_1 > width) {
+        continue;
+      }
+      bool in_ring = prv_ring_row_spans_contain(&spans, x_0);
+      bool in_edge = x_0 < hole_x_0 ? x_0 >= edge_x_0 : x_0 >= hole_x_1 && x_0 < edge_x_1;
+      if (full || in_edge || in_ring != prv_ring_row_spans_contain(&drawn_spans, x_0)) {
+        prv_ring_row_fill(&row_info, bw, x_0, x_1, hole_x_0, hole_x_1, in_ring ? ring : back);
+      }
+    }
+  }
+  graphics_release_frame_buffer(ctx, frame_buffer);
+  return true;
+}
+
+// Draw the center circle, only covering its own anti-aliased edge when the ring was just drawn
+static void prv_render_center_circle(GContext *ctx, GRect bounds, bool ring_drawn) {
+  GPoint center = grect_center_point(&bounds);
+#ifdef PBL_COLOR
+  if (!ring_drawn) {
+    // blending the edge again over itself would darken it, so leave the edge from the last frame
+    graphics_context_set_antialiased(ctx, false);
+    graphics_fill_circle(ctx, center, CIRCLE_RADIUS - 1);
+    graphics_context_set_antialiased(ctx, true);
+    return;
+  }
+#endif
+  graphics_fill_circle(ctx, center, CIRCLE_RADIUS);
 }
 
 // Update the progress ring position based on the current and total values
 static void prv_progress_ring_update(void) {
-  // calculate new angle
-  int32_t new_angle = TRIG_MAX_ANGLE * timer_get_value_ms() / timer_get_length_ms();
-  if (timer_is_chrono()) {
-    new_angle = TRIG_MAX_ANGLE * (timer_get_value_ms() % MSEC_IN_MIN) / MSEC_IN_MIN;
+  // calculate new angle with 32 bit math
+  const TimerSnapshot *snapshot = timer_get_snapshot();
+  int32_t new_angle;
+  if (snapshot->chrono) {
+    uint32_t minute_ms = (uint32_t)snapshot->sec * MSEC_IN_SEC + snapshot->msec;
+    new_angle = minute_ms * TRIG_MAX_ANGLE / MSEC_IN_MIN;
+  } else {
+    // scale both values down until the length fits in 16 bits, so the product can't overflow
+    uint32_t value = snapshot->value_ms;
+    uint32_t length = snapshot->length_ms;
+    if (value > length) {
+      value = length;
+    }
+    while (length > UINT16_MAX) {
+      value >>= 1;
+      length >>= 1;
+    }
+    new_angle = length ? value * TRIG_MAX_ANGLE / length : 0;
   }
   // check if large angle and animate
   animation_stop(&drawing_data.progress_angle);
@@ -303,6 +627,74 @@ static void prv_progress_ring_update(void) {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Background Snapshot
+//
+
+// Copy the framebuffer rows into the snapshot data, or out of it when restoring, then return the
+// number of bytes copied, or 0 if the framebuffer could not be captured
+// With no data, the bytes are only counted, to size the snapshot
+static uint32_t prv_background_snapshot_copy(GContext *ctx, GRect bounds, uint8_t *data,
+                                             bool restore) {
+  GBitmap *frame_buffer = graphics_capture_frame_buffer(ctx);
+  if (!frame_buffer) {
+    return 0;
+  }
+  bool bw = gbitmap_get_format(frame_buffer) == GBitmapFormat1Bit;
+  uint32_t size = 0;
+  for (int16_t y = 0; y < bounds.size.h; y++) {
+    // round displays only store the visible columns of each row
+    GBitmapDataRowInfo row_info = gbitmap_get_data_row_info(frame_buffer, y);
+    uint8_t *row = row_info.data + (bw ? 0 : row_info.min_x);
+    uint16_t length = bw ? row_info.max_x / 8 + 1 : row_info.max_x - row_info.min_x + 1;
+    if (data && restore) {
+      memcpy(row, data + size, length);
+    } else if (data) {
+      memcpy(data + size, row, length);
+    }
+    size += length;
+  }
+  graphics_release_frame_buffer(ctx, frame_buffer);
+  return size;
+}
+
+// Restore the ring and center circle from the snapshot
+static bool prv_background_snapshot_restore(GContext *ctx, GRect bounds) {
+  BackgroundSnapshot *snapshot = &drawing_data.background;
+  return snapshot->valid && prv_background_snapshot_copy(ctx, bounds, snapshot->data, true);
+}
+
+// Snapshot the drawn ring and center circle, unless it would leave less than the reserved heap free
+static void prv_background_snapshot_take(GContext *ctx, GRect bounds) {
+  BackgroundSnapshot *snapshot = &drawing_data.background;
+  if (!snapshot->data) {
+    if (snapshot->attempted) {
+      return;
+    }
+    snapshot->attempted = true;
+    uint32_t size = prv_background_snapshot_copy(ctx, bounds, NULL, false);
+    if (!size || size + BACKGROUND_SNAPSHOT_HEAP_RESERVE > heap_bytes_free()) {
+      APP_LOG(APP_LOG_LEVEL_WARNING, "Background snapshot skipped, %d bytes", (int)size);
+      return;
+    }
+    // drawing falls back to the full ring without a snapshot, so this uses malloc, which can fail,
+    // rather than MALLOC, which asserts
+    snapshot->data = malloc(size);
+    if (!snapshot->data) {
+      return;
+    }
+  }
+  snapshot->valid = prv_background_snapshot_copy(ctx, bounds, snapshot->data, false) > 0;
+  snapshot->angle = drawing_data.progress_angle;
+}
+
+// Destroy the background snapshot
+static void prv_background_snapshot_destroy(void) {
+  BackgroundSnapshot *snapshot = &drawing_data.background;
+  free(snapshot->data);
+  (*snapshot) = (BackgroundSnapshot){0};
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Drawing State Changes
 //
@@ -322,8 +714,8 @@ static bool prv_text_state_compare(DrawState text_state_1, DrawState text_state_
 // Create a state description
 static DrawState prv_draw_state_create(void) {
   // get states
-  uint16_t hr, min, sec;
-  timer_get_time_parts(&hr, &min, &sec);
+  const TimerSnapshot *snapshot = timer_get_snapshot();
+  uint16_t hr = snapshot->hr, min = snapshot->min;
   return (DrawState){
       .control_mode = main_get_control_mode(),
       .hr_digits = (uint8_t)(hr > 0) + (uint8_t)(hr > 9) + (uint8_t)(hr > 99),
@@ -401,32 +793,84 @@ void drawing_start_reset_animation(void) {
 
 // Render everything to the screen
 void drawing_render(Layer *layer, GContext *ctx) {
+  // sample the time once for the whole render pass
+  frame_clock_begin();
+  PROFILE_FRAME_BEGIN();
   // get properties
   GRect bounds = layer_get_bounds(layer);
-  // draw background
-  // this is actually the ring, which is then covered up with the background
-  graphics_context_set_fill_color(ctx, drawing_data.ring_color);
+  // the window is transparent, so the last frame persists and the ring region only needs to be
+  // drawn when its angle changes, and only fully when an animation may have moved something
+  // across it, otherwise just the wedge swept since the last frame
+  bool animating = animation_is_running();
+  // the header and footer text can reach past the center circle, so the ring behind them is drawn
+  // in full whenever their text changes
+  char header[HEADER_TEXT_SIZE];
+  prv_header_text_build(header);
+  prv_footer_model_update();
+  bool sub_text_changed = strcmp(header, drawing_data.drawn_header) != 0 ||
+                          strcmp(drawing_data.footer_model.text, drawing_data.drawn_footer) != 0;
+  memcpy(drawing_data.drawn_header, header, HEADER_TEXT_SIZE);
+  memcpy(drawing_data.drawn_footer, drawing_data.footer_model.text, FORMAT_FIELD_SIZE);
+  PROFILE_SECTION_END(ProfileSectionSubText);
+  bool ring_full =
+      !drawing_data.frame_valid || animating || drawing_data.animating || sub_text_changed;
+  drawing_data.frame_valid = true;
+  drawing_data.animating = animating;
+  // a full redraw starts from the snapshot of the ring and center circle, so only the wedge swept
+  // since it was taken is drawn, and nothing at all while the angle holds still
+  bool restored = ring_full && prv_background_snapshot_restore(ctx, bounds);
+  if (restored) {
+    drawing_data.drawn_angle = drawing_data.background.angle;
+  }
+  bool ring_dirty =
+      (ring_full && !restored) || drawing_data.drawn_angle != drawing_data.progress_angle;
+  if (ring_dirty) {
+    // draw the ring straight into the framebuffer, or with the graphics API if it can't be captured
+    if (!prv_render_progress_ring_spans(ctx, bounds, ring_full && !restored)) {
 #ifdef PBL_BW
-  graphics_fill_rect_grey(ctx, bounds);
-#else
-  graphics_fill_rect(ctx, bounds, 0, GCornerNone);
+      // draw background
+      // this is actually the ring, which is then covered up with the background
+      graphics_fill_rect_grey(ctx, bounds);
 #endif
-  prv_render_progress_ring(ctx, bounds);
-  // draw main circle
-  graphics_context_set_fill_color(ctx, drawing_data.mid_color);
-  graphics_fill_circle(ctx, grect_center_point(&bounds), CIRCLE_RADIUS);
+      prv_render_progress_ring(ctx, bounds);
+    }
+    drawing_data.drawn_angle = drawing_data.progress_angle;
+  }
+  PROFILE_SECTION_END(ProfileSectionRing);
+  // draw main circle, which covers everything drawn inside of it last frame, unless it was just
+  // restored along with the ring
+  if (!restored || ring_dirty) {
+    graphics_context_set_fill_color(ctx, drawing_data.mid_color);
+    prv_render_center_circle(ctx, bounds, ring_dirty);
+  }
+  if (ring_full && ring_dirty) {
+    prv_background_snapshot_take(ctx, bounds);
+  }
+  PROFILE_SECTION_END(ProfileSectionCircle);
   // draw focus layer
   prv_render_focus_layer(ctx);
-  // draw main text (drawn as filled and stroked path)
-  graphics_context_set_stroke_color(ctx, drawing_data.fore_color);
+  PROFILE_SECTION_END(ProfileSectionFocus);
+  // draw main text (drawn as filled rectangles or cached bitmaps)
   graphics_context_set_fill_color(ctx, drawing_data.fore_color);
+  text_render_set_color(drawing_data.fore_color);
   prv_render_main_text(ctx, bounds);
+  PROFILE_SECTION_END(ProfileSectionText);
   // draw header and footer text
   graphics_context_set_text_color(ctx, drawing_data.fore_color);
   prv_render_header_text(ctx, bounds);
+  PROFILE_SECTION_END(ProfileSectionHeader);
   prv_render_footer_text(ctx, bounds);
+  PROFILE_SECTION_END(ProfileSectionFooter);
+  PROFILE_FRAME_END();
+  frame_clock_end();
 }
 
+// Invalidate the last drawn frame so everything is drawn on the next render
+void drawing_invalidate_frame(void) { drawing_data.frame_valid = false; }
+
+// Invalidate the footer text so it is rebuilt on the next render
+void drawing_invalidate_footer(void) { drawing_data.footer_model.valid = false; }
+
 // Update the drawing states and recalculate everythings positions
 void drawing_update(void) {
   // update drawing state
@@ -443,6 +887,8 @@ void drawing_initialize(Layer *layer) {
   drawing_data.layer = layer;
   // set visual states
   drawing_data.progress_angle = 0;
+  drawing_data.frame_valid = false;
+  prv_ring_span_table_create(bounds);
   for (uint8_t ii = 0; ii < TEXT_FIELD_COUNT; ii++) {
     drawing_data.text_fields[ii].origin = grect_center_point(&bounds);
     drawing_data.text_fields[ii].size = GSizeZero;
@@ -460,6 +906,7 @@ void drawing_initialize(Layer *layer) {
   GFont font_gothic_24_bold = fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD);
   GFont font_gothic_28_bold = fonts_get_system_font(FONT_KEY_GOTHIC_28_BOLD);
   GFont font_bebas_35_bold = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_BEBAS_FONT_35));
+  drawing_data.custom_font = font_bebas_35_bold;
   // clang-format off
   scl_set_fonts(ScalableFontLabel, {
     .o = font_gothic_24_bold, // Everything else
@@ -477,9 +924,20 @@ void drawing_initialize(Layer *layer) {
   drawing_data.mid_color = PBL_IF_COLOR_ELSE(GColorMintGreen, GColorWhite);
   drawing_data.ring_color = PBL_IF_COLOR_ELSE(GColorGreen, GColorWhite);
   drawing_data.back_color = PBL_IF_COLOR_ELSE(GColorDarkGray, GColorBlack);
-  // set animation update callback
-  animation_register_update_callback(&prv_animation_update_callback);
+  // step animations from the refresh scheduler
+  animation_register_schedule_callback(&prv_animation_schedule_callback);
+  refresh_register_handler(RefreshSourceAnimation, animation_step_all);
 }
 
 // Destroy the singleton drawing data
-void drawing_terminate(void) { animation_stop_all(); }
+void drawing_terminate(void) {
+  animation_stop_all();
+  text_render_invalidate_cache();
+  fonts_unload_custom_font(drawing_data.custom_font);
+  FREE(drawing_data.ring_rows);
+  drawing_data.ring_rows = NULL;
+  prv_background_snapshot_destroy();
+#ifdef PBL_BW
+  graphics_fill_rect_grey_destroy();
+#endif
+}
@@ -22,11 +22,18 @@ void drawing_start_reset_animation(void);
 //! @param ctx The layer's drawing context
 void drawing_render(Layer *layer, GContext *ctx);
 
+//! Invalidate the footer text so it is rebuilt on the next render, such as when the minute changes
+void drawing_invalidate_footer(void);
+
+//! Invalidate the last drawn frame so everything is drawn on the next render, such as when the
+//! framebuffer was drawn over by a system overlay while the app was out of focus
+void drawing_invalidate_frame(void);
+
 //! Update the drawing states and recalculate everythings positions
 void drawing_update(void);
 
 //! Initialize the singleton drawing data
-//! @param layer The layer which the drawing code can force to refresh, for animations
+//! @param layer The layer which the drawing code lays out its elements in
 void drawing_initialize(Layer *layer);
 
 //! Destroy the singleton drawing data
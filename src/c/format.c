@@ -0,0 +1,76 @@
+// @file format.c
+// @brief Fast integer formatting for the timer display
+//
+// Formats the timer fields and clock times using a constant table of
+// two digit pairs, avoiding the printf family in the render path.
+//
+// @author agent
+// @date October 16, 2026
+
+#include "format.h"
+#include "utility.h"
+
+// Every value from 00 to 99 as a pair of characters
+static const char DIGIT_PAIRS[] = "00010203040506070809"
+                                  "10111213141516171819"
+                                  "20212223242526272829"
+                                  "30313233343536373839"
+                                  "40414243444546474849"
+                                  "50515253545556575859"
+                                  "60616263646566676869"
+                                  "70717273747576777879"
+                                  "80818283848586878889"
+                                  "90919293949596979899";
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+//
+
+// Format a value below 100, dropping the leading zero of single digits unless padded
+static uint8_t prv_format_two_digits(char *buff, uint8_t value, bool pad) {
+  // when skipping the leading zero, the second copied character is overwritten by the terminator
+  uint8_t skip = (value < 10) & !pad;
+  const char *digits = &DIGIT_PAIRS[value * 2 + skip];
+  buff[0] = digits[0];
+  buff[1] = digits[1];
+  buff[2 - skip] = '\0';
+  return 2 - skip;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// API Functions
+//
+
+// Format an unsigned value as decimal digits
+uint8_t format_uint(char *buff, uint16_t value, uint8_t min_digits) {
+  if (value < 100) {
+    return prv_format_two_digits(buff, value, min_digits > 1);
+  }
+  // larger values only occur for very long stopwatches
+  uint8_t length = format_uint(buff, value / 100, 1);
+  return length + prv_format_two_digits(buff + length, value % 100, true);
+}
+
+// Format the timer time parts into the displayed fields
+void format_time_fields(char fields[FORMAT_FIELD_COUNT][FORMAT_FIELD_SIZE], uint16_t hr,
+                        uint16_t min, uint16_t sec, bool edit_mode) {
+  // hours are only shown when set, and padded while editing
+  uint8_t length = format_uint(fields[0], hr, edit_mode ? 2 : 1);
+  fields[0][hr ? length : 0] = '\0';
+  // the first separator is only shown while counting with hours
+  fields[1][0] = ':';
+  fields[1][hr && !edit_mode] = '\0';
+  // minutes are padded when following hours or while editing, seconds are always padded
+  format_uint(fields[2], min, (hr || edit_mode) ? 2 : 1);
+  fields[3][0] = ':';
+  fields[3][!edit_mode] = '\0';
+  format_uint(fields[4], sec, 2);
+}
+
+// Format a clock time as hours and minutes without a leading zero
+uint8_t format_clock_time(char *buff, const struct tm *time, bool is_24h) {
+  uint16_t hr = is_24h ? time->tm_hour : (time->tm_hour + 11) % 12 + 1;
+  uint8_t length = format_uint(buff, hr, 1);
+  buff[length++] = ':';
+  return length + format_uint(buff + length, time->tm_min, 2);
+}
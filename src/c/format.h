@@ -0,0 +1,40 @@
+//! @file format.h
+//! @brief Fast integer formatting for the timer display
+//!
+//! Formats the timer fields and clock times using a constant table of
+//! two digit pairs, avoiding the printf family in the render path.
+//!
+//! @author agent
+//! @date October 16, 2026
+
+#pragma once
+#include <pebble.h>
+
+//! Size of a buffer which can hold any formatted timer field
+#define FORMAT_FIELD_SIZE 6
+
+//! Number of timer fields (hr : min : sec)
+#define FORMAT_FIELD_COUNT 5
+
+//! Format an unsigned value as decimal digits, padded with zeros to a minimum number of digits
+//! @param buff The buffer to write to, must hold at least FORMAT_FIELD_SIZE characters
+//! @param value The value to format
+//! @param min_digits The minimum number of digits to write, either 1 or 2
+//! @return The number of characters written, not counting the NUL terminator
+uint8_t format_uint(char *buff, uint16_t value, uint8_t min_digits);
+
+//! Format the timer time parts into the displayed fields (hr : min : sec)
+//! @param fields The field buffers to write to
+//! @param hr The hours of the timer
+//! @param min The minutes of the timer
+//! @param sec The seconds of the timer
+//! @param edit_mode If the timer is being edited, which pads and separates fields differently
+void format_time_fields(char fields[FORMAT_FIELD_COUNT][FORMAT_FIELD_SIZE], uint16_t hr,
+                        uint16_t min, uint16_t sec, bool edit_mode);
+
+//! Format a clock time as hours and minutes without a leading zero, such as "9:05"
+//! @param buff The buffer to write to, must hold at least FORMAT_FIELD_SIZE characters
+//! @param time The time to format
+//! @param is_24h Format in 24 hour time instead of 12 hour time
+//! @return The number of characters written, not counting the NUL terminator
+uint8_t format_clock_time(char *buff, const struct tm *time, bool is_24h);
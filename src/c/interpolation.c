@@ -5,6 +5,13 @@
 // of different easing modes. Several convenience functions also exist
 // for interpolating different Pebble data types
 //
+// Each easing curve is stored as a Q15 lookup table sampled at 32 even steps of progress, and
+// linearly interpolated between samples. Compared to the exact curves, results are within
+// |to - from| / 1500 + 1. Compared to the previous per-call trigonometry, the sinusoidal curves
+// are within |to - from| / 3000 + 2, and the quadratic curves are within |to - from| / 50 + 2
+// since those used to quantize progress to whole percents. The sinusoidal in-out curve now
+// follows (1 - cos(pi * t)) / 2, where it previously jumped to its end value on completion.
+//
 // @author Eric D. Phillips
 // @date October 31, 2015
 // @bug No known bugs
@@ -12,84 +19,81 @@
 #include "interpolation.h"
 #include <pebble.h>
 
-////////////////////////////////////////////////////////////////////////////////////////////////////
-// Private Functions
-//
-
-// Linear interpolation
-static int32_t prv_curve_linear(int32_t from, int32_t to, uint32_t percent, uint32_t percent_max) {
-  return from + (to - from) * (int32_t)percent / (int32_t)percent_max;
-}
+// Easing table constants
+#define EASING_TABLE_STEPS 32 //< Number of segments in each easing table
+#define EASING_TABLE_SHIFT 10 //< log2(INTERPOLATION_PROGRESS_MAX / EASING_TABLE_STEPS)
+#define PROGRESS_SHIFT 15     //< log2(INTERPOLATION_PROGRESS_MAX)
 
-// Quadratic interpolation in
-static int32_t prv_curve_quad_ease_in(int32_t from, int32_t to, uint32_t percent,
-                                      uint32_t percent_max) {
-  int32_t t_percent = percent * 100 / percent_max;
-  return (to - from) * t_percent * t_percent / 10000 + from;
-}
+// Eased progress for each curve at every table step, in units of INTERPOLATION_PROGRESS_MAX
+static const uint16_t EASING_TABLES[][EASING_TABLE_STEPS + 1] = {
+    // CurveLinear
+    {0, 1024, 2048, 3072, 4096, 5120, 6144, 7168, 8192, 9216, 10240, 11264, 12288, 13312, 14336,
+     15360, 16384, 17408, 18432, 19456, 20480, 21504, 22528, 23552, 24576, 25600, 26624, 27648,
+     28672, 29696, 30720, 31744, 32768},
+    // CurveQuadEaseIn
+    {0, 32, 128, 288, 512, 800, 1152, 1568, 2048, 2592, 3200, 3872, 4608, 5408, 6272, 7200, 8192,
+     9248, 10368, 11552, 12800, 14112, 15488, 16928, 18432, 20000, 21632, 23328, 25088, 26912,
+     28800, 30752, 32768},
+    // CurveQuadEaseOut
+    {0, 2016, 3968, 5856, 7680, 9440, 11136, 12768, 14336, 15840, 17280, 18656, 19968, 21216, 22400,
+     23520, 24576, 25568, 26496, 27360, 28160, 28896, 29568, 30176, 30720, 31200, 31616, 31968,
+     32256, 32480, 32640, 32736, 32768},
+    // CurveQuadEaseInOut
+    {0, 64, 256, 576, 1024, 1600, 2304, 3136, 4096, 5184, 6400, 7744, 9216, 10816, 12544, 14400,
+     16384, 18368, 20224, 21952, 23552, 25024, 26368, 27584, 28672, 29632, 30464, 31168, 31744,
+     32192, 32512, 32704, 32768},
+    // CurveSinEaseIn
+    {0, 39, 158, 355, 630, 982, 1411, 1915, 2494, 3146, 3869, 4662, 5522, 6448, 7438, 8489, 9598,
+     10762, 11980, 13248, 14563, 15922, 17321, 18758, 20228, 21729, 23256, 24806, 26375, 27960,
+     29556, 31160, 32768},
+    // CurveSinEaseOut
+    {0, 1608, 3212, 4808, 6393, 7962, 9512, 11039, 12540, 14010, 15447, 16846, 18205, 19520, 20788,
+     22006, 23170, 24279, 25330, 26320, 27246, 28106, 28899, 29622, 30274, 30853, 31357, 31786,
+     32138, 32413, 32610, 32729, 32768},
+    // CurveSinEaseInOut
+    {0, 79, 315, 705, 1247, 1935, 2761, 3719, 4799, 5990, 7282, 8661, 10114, 11628, 13188, 14778,
+     16384, 17990, 19580, 21140, 22654, 24107, 25486, 26778, 27969, 29049, 30007, 30833, 31521,
+     32063, 32453, 32689, 32768},
+};
 
-// Quadratic interpolation out
-static int32_t prv_curve_quad_ease_out(int32_t from, int32_t to, uint32_t percent,
-                                       uint32_t percent_max) {
-  int32_t t_percent = percent * 100 / percent_max;
-  return -(to - from) * t_percent * (t_percent - 200) / 10000 + from;
-}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// API Functions
+//
 
-// Quadratic interpolation in out
-static int32_t prv_curve_quad_ease_in_out(int32_t from, int32_t to, uint32_t percent,
-                                          uint32_t percent_max) {
-  int32_t t_percent = percent * 200 / percent_max;
-  if (t_percent < 100) {
-    return (to - from) / 2 * t_percent * t_percent / 10000 + from;
+// Get the eased progress of an animation
+int32_t interpolation_get_progress(uint32_t percent, uint32_t percent_max,
+                                   InterpolationCurve curve) {
+  if (percent >= percent_max) {
+    return INTERPOLATION_PROGRESS_MAX;
   }
-  t_percent -= 100;
-  return -(to - from) / 2 * (t_percent * (t_percent - 200) - 10000) / 10000 + from;
-}
-
-// Sinusoidal interpolation in
-static int32_t prv_curve_sin_ease_in(int32_t from, int32_t to, uint32_t percent,
-                                     uint32_t percent_max) {
-  return (-((to - from) / 2) * cos_lookup(TRIG_MAX_ANGLE * percent / percent_max / 4)) /
-             (TRIG_MAX_RATIO / 2) +
-         (to - from) + from;
-}
-
-// Sinusoidal interpolation out
-static int32_t prv_curve_sin_ease_out(int32_t from, int32_t to, uint32_t percent,
-                                      uint32_t percent_max) {
-  return (((to - from) / 2) * sin_lookup(TRIG_MAX_ANGLE * percent / percent_max / 4)) /
-             (TRIG_MAX_RATIO / 2) +
-         from;
+  // keep the fixed-point product within 32 bits for very long animations
+  while (percent_max > UINT16_MAX) {
+    percent >>= 1;
+    percent_max >>= 1;
+  }
+  // find linear progress, then ease it by interpolating between neighbouring table entries
+  uint32_t progress = (percent << PROGRESS_SHIFT) / percent_max;
+  uint32_t idx = progress >> EASING_TABLE_SHIFT;
+  int32_t fraction = progress & ((1 << EASING_TABLE_SHIFT) - 1);
+  const uint16_t *table = EASING_TABLES[curve];
+  return table[idx] + (((table[idx + 1] - table[idx]) * fraction) >> EASING_TABLE_SHIFT);
 }
 
-// Sinusoidal interpolation in out
-static int32_t prv_curve_sin_ease_in_out(int32_t from, int32_t to, uint32_t percent,
-                                         uint32_t percent_max) {
-  return (-((to - from) / 2) *
-          (cos_lookup(TRIG_MAX_ANGLE * percent / percent_max / 2) - (TRIG_MAX_RATIO / 2)) / 2) /
-             TRIG_MAX_RATIO +
-         from;
+// Interpolate an integer by eased progress
+int32_t interpolation_integer_progress(int32_t from, int32_t to, int32_t progress) {
+  // round to nearest, the 64 bit product is a single multiply instruction
+  return from + (int32_t)(((int64_t)(to - from) * progress + (1 << (PROGRESS_SHIFT - 1))) >>
+                          PROGRESS_SHIFT);
 }
 
-// Array of interpolation function pointers
-typedef int32_t (*InterpolationFunction)(int32_t, int32_t, uint32_t, uint32_t);
-InterpolationFunction interpolation_functions[] = {
-    prv_curve_linear,           prv_curve_quad_ease_in, prv_curve_quad_ease_out,
-    prv_curve_quad_ease_in_out, prv_curve_sin_ease_in,  prv_curve_sin_ease_out,
-    prv_curve_sin_ease_in_out,
-};
-
-////////////////////////////////////////////////////////////////////////////////////////////////////
-// API Functions
-//
-
 // Interpolate an integer
 int32_t interpolation_integer(int32_t from, int32_t to, uint32_t percent, uint32_t percent_max,
                               InterpolationCurve curve) {
   if (percent >= percent_max) {
     return to;
   }
-  return interpolation_functions[curve](from, to, percent, percent_max);
+  int32_t progress = interpolation_get_progress(percent, percent_max, curve);
+  return interpolation_integer_progress(from, to, progress);
 }
 
 // Interpolate a GPoint
@@ -98,6 +102,7 @@ GPoint interpolation_gpoint(GPoint from, GPoint to, uint32_t percent, uint32_t p
   if (percent >= percent_max) {
     return to;
   }
-  return GPoint(interpolation_integer(from.x, to.x, percent, percent_max, curve),
-                interpolation_integer(from.y, to.y, percent, percent_max, curve));
+  int32_t progress = interpolation_get_progress(percent, percent_max, curve);
+  return GPoint(interpolation_integer_progress(from.x, to.x, progress),
+                interpolation_integer_progress(from.y, to.y, progress));
 }
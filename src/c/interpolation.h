@@ -22,6 +22,24 @@ typedef enum InterpolationCurve {
   CurveSinEaseInOut
 } InterpolationCurve;
 
+//! Fixed-point eased progress value at which an animation is complete
+#define INTERPOLATION_PROGRESS_MAX 32768
+
+//! Get the eased progress of an animation, to be shared by every component of an animated value
+//! @param percent The percent of the way into the animation
+//! @param percent_max The maximum percent to end the animation at
+//! @param curve The interpolation curve to ease the progress with
+//! @return The eased progress, from 0 to INTERPOLATION_PROGRESS_MAX
+int32_t interpolation_get_progress(uint32_t percent, uint32_t percent_max,
+                                   InterpolationCurve curve);
+
+//! Interpolation for integer value by already eased progress
+//! @param from The beginning value
+//! @param to The ending value
+//! @param progress The eased progress from interpolation_get_progress
+//! @return The interpolated value
+int32_t interpolation_integer_progress(int32_t from, int32_t to, int32_t progress);
+
 //! Interpolation for integer value
 //! @param from The beginning value
 //! @param to The ending value
@@ -8,7 +8,9 @@
 // @bugs No known bugs
 
 #include "main.h"
+#include "benchmark.h"
 #include "drawing.h"
+#include "refresh.h"
 #include "timer.h"
 #include "utility.h"
 #include <pebble.h>
@@ -16,22 +18,99 @@
 // Main constants
 #define BUTTON_HOLD_REPEAT_MS 100
 #define SYSTEM_ENTRANCE_ANIMATION_MS 400
+// Wake up this long before a countdown expires, so the app is already running when it goes off
+#ifndef WAKEUP_PREWARM_MS
+#define WAKEUP_PREWARM_MS 3000
+#endif
 
 // Main data structure
 static struct {
   Window *window;           //< The base window for the application
   Layer *layer;             //< The base layer on which everything will be drawn
   ControlMode control_mode; //< The current control mode of the timer
-  AppTimer *app_timer;      //< The AppTimer to keep the screen refreshing
+  uint64_t elapsed_time;    //< Frame time the timer was last checked for elapsing
+  uint8_t elapsed_timer;    //< Index of the timer last checked for elapsing
 } main_data;
 
-// Function declarations
-static void prv_app_timer_callback(void *data);
-
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Private Functions
 //
 
+// Schedule a refresh for when the displayed timer second next changes, only while counting
+static void prv_second_refresh_schedule(void) {
+  if (main_data.control_mode != ControlModeCounting || timer_is_paused()) {
+    refresh_cancel(RefreshSourceSecond);
+    return;
+  }
+  frame_clock_begin();
+  // a countdown changes second once the remainder drops below the current whole second, while
+  // a stopwatch changes once it reaches the next whole second
+  const TimerSnapshot *snapshot = timer_get_snapshot();
+  uint32_t delay = snapshot->chrono ? MSEC_IN_SEC - snapshot->msec : snapshot->msec + 1;
+  refresh_schedule(RefreshSourceSecond, delay);
+  frame_clock_end();
+}
+
+// Schedule a refresh for when the wall clock minute next changes
+static void prv_minute_refresh_schedule(void) {
+  refresh_schedule(RefreshSourceMinute, MSEC_IN_MIN - frame_clock_now() % MSEC_IN_MIN);
+}
+
+// Schedule a refresh for when the earliest running countdown among all timers expires
+static void prv_expiry_refresh_schedule(void) {
+  int64_t expiry = timer_get_next_expiry_ms();
+  if (!expiry) {
+    refresh_cancel(RefreshSourceExpiry);
+    return;
+  }
+  int64_t delay = expiry - (int64_t)frame_clock_now();
+  refresh_schedule(RefreshSourceExpiry, delay > 0 ? delay : 0);
+}
+
+// Check if the selected timer elapsed, at most once per refresh pass, so that the second and
+// expiry refreshes falling due together only vibrate once
+static void prv_timer_check_elapsed(void) {
+  uint64_t now = frame_clock_now();
+  if (main_data.elapsed_time == now && main_data.elapsed_timer == timer_get_selected()) {
+    return;
+  }
+  main_data.elapsed_time = now;
+  main_data.elapsed_timer = timer_get_selected();
+  timer_check_elapsed();
+}
+
+// Refresh after input changed the timer or control mode
+static void prv_input_refresh(void) {
+  prv_second_refresh_schedule();
+  prv_expiry_refresh_schedule();
+  refresh_schedule(RefreshSourceInput, 0);
+}
+
+// Set the control mode to match the selected timer, counting if running and editing if paused
+static void prv_control_mode_select(void) {
+  if (timer_is_paused()) {
+    // get time parts
+    uint16_t hr, min, sec;
+    timer_get_time_parts(&hr, &min, &sec);
+    if (hr) {
+      main_data.control_mode = ControlModeEditHr;
+    } else {
+      main_data.control_mode = ControlModeEditMin;
+    }
+  } else {
+    main_data.control_mode = ControlModeCounting;
+  }
+}
+
+// Select another timer in the table and show it, staying in counting mode even if it is stopped
+// so that up and down keep switching timers
+static void prv_timer_cycle(int8_t step) {
+  timer_select(timer_get_selected() + TIMER_COUNT + step);
+  main_data.control_mode = ControlModeCounting;
+  drawing_update();
+  prv_input_refresh();
+}
+
 // Rewind timer if button is clicked to stop vibration
 static bool main_timer_rewind(void) {
   // check if timer is vibrating
@@ -40,6 +119,7 @@ static bool main_timer_rewind(void) {
     main_data.control_mode = ControlModeEditSec;
     timer_rewind();
     drawing_update();
+    prv_input_refresh();
     return true;
   }
   return false;
@@ -54,10 +134,26 @@ ControlMode main_get_control_mode(void) { return main_data.control_mode; }
 
 // Background layer update procedure
 static void prv_layer_update_proc_handler(Layer *layer, GContext *ctx) {
+#ifdef BENCHMARK
+  // time drawing on the first frame, which then draws everything over the benchmarks' output
+  static bool benchmarked = false;
+  if (!benchmarked) {
+    benchmarked = true;
+    benchmark_run_render(layer, ctx);
+  }
+#endif
   // render the timer's visuals
   drawing_render(layer, ctx);
 }
 
+// App focus handler, redrawing everything once any system overlay has been dismissed
+static void prv_app_did_focus_handler(bool in_focus) {
+  if (in_focus) {
+    drawing_invalidate_frame();
+    refresh_schedule(RefreshSourceInput, 0);
+  }
+}
+
 // Back click handler
 static void prv_back_click_handler(ClickRecognizerRef recognizer, void *ctx) {
   // cancel vibrations
@@ -69,18 +165,28 @@ static void prv_back_click_handler(ClickRecognizerRef recognizer, void *ctx) {
   if ((hr && main_data.control_mode == ControlModeEditMin) ||
       main_data.control_mode == ControlModeEditSec) {
     main_data.control_mode--;
+  } else if (main_data.control_mode != ControlModeCounting && timer_get_running_count()) {
+    // go back to switching between timers while any are running
+    main_data.control_mode = ControlModeCounting;
   } else {
     window_stack_pop(true);
   }
   // refresh
   drawing_update();
-  layer_mark_dirty(main_data.layer);
+  prv_input_refresh();
 }
 
 // Up click handler
 static void prv_up_click_handler(ClickRecognizerRef recognizer, void *ctx) {
   // rewind timer if clicked while timer is going off
-  if (main_timer_rewind() || main_data.control_mode == ControlModeCounting) {
+  if (main_timer_rewind()) {
+    return;
+  }
+  // switch timers while counting
+  if (main_data.control_mode == ControlModeCounting) {
+    if (!click_recognizer_is_repeating(recognizer)) {
+      prv_timer_cycle(-1);
+    }
     return;
   }
   // increment timer
@@ -105,7 +211,7 @@ static void prv_up_click_handler(ClickRecognizerRef recognizer, void *ctx) {
     main_data.control_mode = ControlModeEditHr;
   }
   // check if switched out of ControlModeEditHr
-  if (timer_get_value_ms() / MSEC_IN_HR == 0 && main_data.control_mode == ControlModeEditHr) {
+  if (timer_get_snapshot()->hr == 0 && main_data.control_mode == ControlModeEditHr) {
     main_data.control_mode = ControlModeEditMin;
   }
   // animate and refresh
@@ -113,7 +219,7 @@ static void prv_up_click_handler(ClickRecognizerRef recognizer, void *ctx) {
     drawing_start_bounce_animation(true);
   }
   drawing_update();
-  layer_mark_dirty(main_data.layer);
+  prv_input_refresh();
 }
 
 // Select click handler
@@ -133,18 +239,20 @@ static void prv_select_click_handler(ClickRecognizerRef recognizer, void *ctx) {
   case ControlModeEditSec:
     main_data.control_mode = ControlModeCounting;
     timer_toggle_play_pause();
-    if (!main_data.app_timer) {
-      prv_app_timer_callback(NULL);
-    }
     break;
   case ControlModeCounting:
+    if (timer_is_paused()) {
+      // a stopped timer switched to from another one is edited rather than started
+      prv_control_mode_select();
+      break;
+    }
     main_data.control_mode = ControlModeEditSec;
     timer_toggle_play_pause();
     break;
   }
   // refresh
   drawing_update();
-  layer_mark_dirty(main_data.layer);
+  prv_input_refresh();
 }
 
 // Select raw click handler
@@ -153,7 +261,7 @@ static void prv_select_raw_click_handler(ClickRecognizerRef recognizer, void *ct
   vibes_cancel();
   // animate and refresh
   drawing_start_reset_animation();
-  layer_mark_dirty(main_data.layer);
+  prv_input_refresh();
 }
 
 // Select long click handler
@@ -162,13 +270,20 @@ static void prv_select_long_click_handler(ClickRecognizerRef recognizer, void *c
   timer_reset();
   // animate and refresh
   drawing_update();
-  layer_mark_dirty(main_data.layer);
+  prv_input_refresh();
 }
 
 // Down click handler
 static void prv_down_click_handler(ClickRecognizerRef recognizer, void *ctx) {
   // rewind timer if clicked while timer is going off
-  if (main_timer_rewind() || main_data.control_mode == ControlModeCounting) {
+  if (main_timer_rewind()) {
+    return;
+  }
+  // switch timers while counting
+  if (main_data.control_mode == ControlModeCounting) {
+    if (!click_recognizer_is_repeating(recognizer)) {
+      prv_timer_cycle(1);
+    }
     return;
   }
   // increment timer
@@ -182,7 +297,7 @@ static void prv_down_click_handler(ClickRecognizerRef recognizer, void *ctx) {
   }
   timer_increment(increment);
   // check if switched out of ControlModeEditHr
-  if (timer_get_value_ms() / MSEC_IN_HR == 0 && main_data.control_mode == ControlModeEditHr) {
+  if (timer_get_snapshot()->hr == 0 && main_data.control_mode == ControlModeEditHr) {
     main_data.control_mode = ControlModeEditMin;
   }
   // animate and refresh
@@ -190,7 +305,7 @@ static void prv_down_click_handler(ClickRecognizerRef recognizer, void *ctx) {
     drawing_start_bounce_animation(false);
   }
   drawing_update();
-  layer_mark_dirty(main_data.layer);
+  prv_input_refresh();
 }
 
 // Click configuration provider
@@ -206,28 +321,39 @@ static void prv_click_config_provider(void *ctx) {
                                           prv_down_click_handler);
 }
 
-// AppTimer callback
-static void prv_app_timer_callback(void *data) {
+// Refresh handler for when the displayed timer second changes
+static bool prv_second_refresh_handler(void) {
   // check if timer is complete
-  timer_check_elapsed();
+  prv_timer_check_elapsed();
   // refresh
   drawing_update();
-  layer_mark_dirty(main_data.layer);
-  // schedule next call
-  main_data.app_timer = NULL;
-  if (main_data.control_mode == ControlModeCounting) {
-    uint32_t duration = timer_get_value_ms() % MSEC_IN_SEC;
-    if (timer_is_chrono()) {
-      duration = MSEC_IN_SEC - duration;
-    }
-    main_data.app_timer = app_timer_register(duration + 5, prv_app_timer_callback, NULL);
+  prv_second_refresh_schedule();
+  return true;
+}
+
+// Refresh handler for when a countdown expires, which selects and shows it
+static bool prv_expiry_refresh_handler(void) {
+  bool expired = timer_select_expired();
+  if (expired) {
+    main_data.control_mode = ControlModeCounting;
+    // start vibrating right at the deadline, rather than on the next second refresh
+    prv_timer_check_elapsed();
+    drawing_update();
+    prv_second_refresh_schedule();
   }
+  prv_expiry_refresh_schedule();
+  return expired;
 }
 
-// TickTimerService callback
-static void prv_tick_timer_service_callback(struct tm *tick_time, TimeUnits units_changed) {
-  // refresh
-  layer_mark_dirty(main_data.layer);
+// Refresh handler for when the wall clock minute changes
+static bool prv_minute_refresh_handler(void) {
+  // refresh, the footer end time changes with the minute
+  drawing_invalidate_footer();
+#ifdef HEAP_INSTRUMENTATION
+  heap_stats_log();
+#endif
+  prv_minute_refresh_schedule();
+  return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -236,72 +362,89 @@ static void prv_tick_timer_service_callback(struct tm *tick_time, TimeUnits unit
 
 // Initialize the program
 static void prv_initialize(void) {
+#ifdef HEAP_INSTRUMENTATION
+  heap_stats_begin();
+#endif
+#ifdef BENCHMARK
+  benchmark_run();
+#endif
   // cancel any existing wakeup events
   wakeup_cancel_all();
   // load timer
   timer_persist_read();
-  // set initial states
-  if (timer_is_paused()) {
-    // get time parts
-    uint16_t hr, min, sec;
-    timer_get_time_parts(&hr, &min, &sec);
-    if (hr) {
-      main_data.control_mode = ControlModeEditHr;
-    } else {
-      main_data.control_mode = ControlModeEditMin;
-    }
-  } else {
-    main_data.control_mode = ControlModeCounting;
+  // set initial states, showing any countdown which expired while closed, or the countdown about
+  // to expire if woken up early to pre-warm
+  AppLaunchReason reason = launch_reason();
+  if (!timer_select_expired() && reason == APP_LAUNCH_WAKEUP) {
+    timer_select_next_expiry();
   }
+  prv_control_mode_select();
 
   // initialize window
   main_data.window = window_create();
   ASSERT(main_data.window);
   window_set_click_config_provider(main_data.window, prv_click_config_provider);
+  // keep the last frame in the framebuffer, so unchanged regions don't need to be drawn again
+  window_set_background_color(main_data.window, GColorClear);
   Layer *window_root = window_get_root_layer(main_data.window);
   GRect window_bounds = layer_get_bounds(window_root);
 #ifdef PBL_SDK_2
   window_set_fullscreen(main_data.window, true);
   window_bounds.size.h = 168;
 #endif
-  window_stack_push(main_data.window, true);
+  // skip the window animation when woken up, so the app is ready as soon as possible
+  window_stack_push(main_data.window, reason != APP_LAUNCH_WAKEUP);
   // initialize main layer
   main_data.layer = layer_create(window_bounds);
   ASSERT(main_data.layer);
   layer_set_update_proc(main_data.layer, prv_layer_update_proc_handler);
   layer_add_child(window_root, main_data.layer);
 
-  // initialize drawing singleton
+  // initialize refresh scheduler and drawing singleton
+  refresh_initialize(main_data.layer);
+  refresh_register_handler(RefreshSourceSecond, prv_second_refresh_handler);
+  refresh_register_handler(RefreshSourceMinute, prv_minute_refresh_handler);
+  refresh_register_handler(RefreshSourceExpiry, prv_expiry_refresh_handler);
   drawing_initialize(main_data.layer);
-  // subscribe to tick timer service
-  tick_timer_service_subscribe(MINUTE_UNIT, prv_tick_timer_service_callback);
+  app_focus_service_subscribe_handlers((AppFocusHandlers){
+      .did_focus = prv_app_did_focus_handler,
+  });
   // start refreshing
-  AppLaunchReason reason = launch_reason();
+  prv_minute_refresh_schedule();
+  prv_expiry_refresh_schedule();
   if (reason == APP_LAUNCH_QUICK_LAUNCH || reason == APP_LAUNCH_WAKEUP) {
     // launch timer immediately for wakeups and quick launches
-    prv_app_timer_callback(NULL);
+    refresh_schedule(RefreshSourceSecond, 0);
   } else {
     // the system opening animation freezes the app on the first frame, wait until that is done
     // before animating elements in (ideally there would be a better way to detect/get when the
     // system animation finished)
-    app_timer_register(SYSTEM_ENTRANCE_ANIMATION_MS, prv_app_timer_callback, NULL);
+    refresh_schedule(RefreshSourceSecond, SYSTEM_ENTRANCE_ANIMATION_MS);
   }
 }
 
 // Terminate the program
 static void prv_terminate(void) {
-  // unsubscribe from timer service
-  tick_timer_service_unsubscribe();
-  // schedule wakeup
-  if (!timer_is_chrono() && !timer_is_paused()) {
-    time_t wakeup_time = (epoch() + timer_get_value_ms()) / MSEC_IN_SEC;
-    wakeup_schedule(wakeup_time, 0, true);
+  // stop refreshing
+  app_focus_service_unsubscribe();
+  refresh_terminate();
+  // schedule a wakeup for the earliest countdown, which schedules the next one when it closes
+  int64_t expiry = timer_get_next_expiry_ms();
+  if (expiry) {
+    // wake early to pre-warm, but never in the past if the countdown is about to expire
+    time_t wakeup_time = (expiry - WAKEUP_PREWARM_MS) / MSEC_IN_SEC;
+    time_t min_wakeup_time = epoch() / MSEC_IN_SEC + 1;
+    wakeup_schedule(wakeup_time > min_wakeup_time ? wakeup_time : min_wakeup_time, 0, true);
   }
   // destroy
   timer_persist_store();
   drawing_terminate();
   layer_destroy(main_data.layer);
   window_destroy(main_data.window);
+#ifdef HEAP_INSTRUMENTATION
+  heap_stats_log();
+  heap_stats_report_leaks();
+#endif
 }
 
 // Entry point
@@ -0,0 +1,136 @@
+// @file profile.c
+// @brief Per-frame render profiler
+//
+// Times each section of a render pass and keeps a rolling histogram of
+// the cost of each one, periodically logging the p50/p99 cost of every
+// section and the frame rate, along with how many pixels the ring's span
+// writer wrote over with the value they already had and the glyph cache's
+// hits and misses. Compiled out unless building with PROFILE_RENDER
+// defined, in which case the macros do nothing.
+//
+// @author agent
+// @date October 16, 2026
+
+#include "profile.h"
+
+#ifdef PROFILE_RENDER
+#include "text_render.h"
+#include "utility.h"
+
+#define PROFILE_WINDOW 64         //< Number of most recent samples kept per section
+#define PROFILE_BUCKETS 64        //< Number of 1 millisecond histogram buckets, the last is open
+#define PROFILE_LOG_INTERVAL 5000 //< Milliseconds between logging statistics
+
+// Names of each section for logging
+static const char *PROFILE_SECTION_NAMES[ProfileSectionCount] = {
+    "sub_text", "ring", "circle", "focus", "text", "header", "footer", "frame",
+};
+
+// Rolling histogram of the most recent samples of one section
+typedef struct {
+  uint8_t samples[PROFILE_WINDOW];  //< Circular buffer of the most recent samples, in buckets
+  uint8_t buckets[PROFILE_BUCKETS]; //< Number of samples in the window in each bucket
+  uint8_t next;                     //< Index in the circular buffer to write the next sample
+  uint8_t count;                    //< Number of samples in the window
+} ProfileHistogram;
+
+// Profiler data
+static struct {
+  ProfileHistogram histograms[ProfileSectionCount]; //< Histogram of each section
+  uint64_t frame_start;                              //< Epoch the current frame began
+  uint64_t section_start;                            //< Epoch the current section began
+  uint64_t log_start;                                //< Epoch statistics were last logged
+  uint16_t log_frames;                               //< Frames since statistics were last logged
+  uint32_t log_pixels_written;   //< Pixels written since statistics were last logged
+  uint32_t log_pixels_unchanged; //< Pixels rewritten unchanged since statistics were last logged
+} profile_data;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+//
+
+// Add a sample to a histogram, replacing the oldest once the window is full
+static void prv_histogram_add(ProfileHistogram *histogram, uint64_t duration) {
+  uint8_t bucket = duration < PROFILE_BUCKETS ? duration : PROFILE_BUCKETS - 1;
+  if (histogram->count == PROFILE_WINDOW) {
+    histogram->buckets[histogram->samples[histogram->next]]--;
+  } else {
+    histogram->count++;
+  }
+  histogram->samples[histogram->next] = bucket;
+  histogram->buckets[bucket]++;
+  histogram->next = (histogram->next + 1) % PROFILE_WINDOW;
+}
+
+// Get the bucket a percentile of the samples fall at or under
+static uint8_t prv_histogram_percentile(ProfileHistogram *histogram, uint8_t percentile) {
+  uint16_t target = (histogram->count * percentile + 99) / 100;
+  uint16_t total = 0;
+  for (uint8_t ii = 0; ii < PROFILE_BUCKETS; ii++) {
+    total += histogram->buckets[ii];
+    if (total >= target) {
+      return ii;
+    }
+  }
+  return PROFILE_BUCKETS - 1;
+}
+
+// Log the cost of every section and the frame rate
+static void prv_profile_log(uint64_t now) {
+  uint32_t elapsed = now - profile_data.log_start;
+  APP_LOG(APP_LOG_LEVEL_INFO, "profile,fps,%d.%d", (int)(profile_data.log_frames * 1000 / elapsed),
+          (int)(profile_data.log_frames * 10000 / elapsed % 10));
+  for (uint8_t ii = 0; ii < ProfileSectionCount; ii++) {
+    ProfileHistogram *histogram = &profile_data.histograms[ii];
+    APP_LOG(APP_LOG_LEVEL_INFO, "profile,%s,p50 %dms,p99 %dms", PROFILE_SECTION_NAMES[ii],
+            prv_histogram_percentile(histogram, 50), prv_histogram_percentile(histogram, 99));
+  }
+  uint16_t frames = profile_data.log_frames ? profile_data.log_frames : 1;
+  APP_LOG(APP_LOG_LEVEL_INFO, "profile,ring_pixels,%d written,%d unchanged",
+          (int)(profile_data.log_pixels_written / frames),
+          (int)(profile_data.log_pixels_unchanged / frames));
+  uint32_t hits, misses;
+  text_render_get_cache_stats(&hits, &misses);
+  APP_LOG(APP_LOG_LEVEL_INFO, "profile,glyph_cache,%d hits,%d misses", (int)hits, (int)misses);
+  profile_data.log_start = now;
+  profile_data.log_frames = 0;
+  profile_data.log_pixels_written = 0;
+  profile_data.log_pixels_unchanged = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// API Functions
+//
+
+// Begin timing a frame
+void profile_frame_begin(void) {
+  profile_data.frame_start = profile_data.section_start = epoch();
+  if (!profile_data.log_start) {
+    profile_data.log_start = profile_data.frame_start;
+  }
+}
+
+// End a section, timed from the end of the previous section or the start of the frame
+void profile_section_end(ProfileSection section) {
+  uint64_t now = epoch();
+  prv_histogram_add(&profile_data.histograms[section], now - profile_data.section_start);
+  profile_data.section_start = now;
+}
+
+// Count pixels written straight into the framebuffer
+void profile_pixels_add(uint32_t written, uint32_t unchanged) {
+  profile_data.log_pixels_written += written;
+  profile_data.log_pixels_unchanged += unchanged;
+}
+
+// End timing a frame, logging the statistics if it has been long enough since they were logged
+void profile_frame_end(void) {
+  uint64_t now = epoch();
+  prv_histogram_add(&profile_data.histograms[ProfileSectionFrame], now - profile_data.frame_start);
+  profile_data.log_frames++;
+  if (now - profile_data.log_start >= PROFILE_LOG_INTERVAL) {
+    prv_profile_log(now);
+  }
+}
+
+#endif
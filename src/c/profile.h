@@ -0,0 +1,58 @@
+//! @file profile.h
+//! @brief Per-frame render profiler
+//!
+//! Times each section of a render pass and keeps a rolling histogram of
+//! the cost of each one, periodically logging the p50/p99 cost of every
+//! section and the frame rate, along with how many pixels the ring's span
+//! writer wrote over with the value they already had and the glyph cache's
+//! hits and misses. Compiled out unless building with PROFILE_RENDER
+//! defined, in which case the macros do nothing.
+//!
+//! @author agent
+//! @date October 16, 2026
+
+#pragma once
+#include <pebble.h>
+
+//! List of timed sections of a render pass
+typedef enum ProfileSection {
+  ProfileSectionSubText,
+  ProfileSectionRing,
+  ProfileSectionCircle,
+  ProfileSectionFocus,
+  ProfileSectionText,
+  ProfileSectionHeader,
+  ProfileSectionFooter,
+  ProfileSectionFrame,
+  ProfileSectionCount
+} ProfileSection;
+
+//! Profiling macros, which compile to nothing unless profiling
+#ifdef PROFILE_RENDER
+#define PROFILE_FRAME_BEGIN() profile_frame_begin()
+#define PROFILE_SECTION_END(section) profile_section_end(section)
+#define PROFILE_FRAME_END() profile_frame_end()
+#define PROFILE_PIXELS(written, unchanged) profile_pixels_add(written, unchanged)
+#else
+#define PROFILE_FRAME_BEGIN() ((void)0)
+#define PROFILE_SECTION_END(section) ((void)0)
+#define PROFILE_FRAME_END() ((void)0)
+#define PROFILE_PIXELS(written, unchanged) ((void)0)
+#endif
+
+#ifdef PROFILE_RENDER
+//! Begin timing a frame
+void profile_frame_begin(void);
+
+//! End a section, timed from the end of the previous section or the start of the frame
+//! @param section The section which just finished
+void profile_section_end(ProfileSection section);
+
+//! Count pixels written straight into the framebuffer
+//! @param written The number of pixels written
+//! @param unchanged The number of those pixels which already had the value written
+void profile_pixels_add(uint32_t written, uint32_t unchanged);
+
+//! End timing a frame, logging the statistics if it has been long enough since they were logged
+void profile_frame_end(void);
+#endif
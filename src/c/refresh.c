@@ -0,0 +1,117 @@
+// @file refresh.c
+// @brief Single scheduler for every reason to redraw the screen
+//
+// Owns the only AppTimer used to refresh the screen. Each refresh source keeps
+// its own deadline, and the AppTimer always sleeps until the nearest of them.
+// All sources which are due when it fires are handled together, and the layer
+// is marked dirty at most once for the whole pass.
+//
+// @author agent
+// @date October 16, 2026
+
+#include "refresh.h"
+#include "animation.h"
+#include "utility.h"
+
+// Animation frames may be stepped up to a frame early to share a pass with an exact deadline,
+// since animations are stepped by the clock and not by a frame count
+static const uint32_t REFRESH_SOURCE_SLACK[RefreshSourceCount] = {
+    [RefreshSourceAnimation] = ANIMATION_TICK_INTERVAL,
+};
+
+// Main data
+static struct {
+  Layer *layer;                                //< The layer to mark dirty
+  AppTimer *timer;                             //< The single refresh AppTimer
+  uint64_t timer_deadline;                     //< Millisecond epoch the AppTimer fires at
+  uint64_t deadlines[RefreshSourceCount];      //< Millisecond epoch each source is due, or 0
+  RefreshHandler handlers[RefreshSourceCount]; //< Handler raised when each source is due
+} refresh_data;
+
+// Function declarations
+static void prv_refresh_timer_start(void);
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+//
+
+// AppTimer callback, which handles every source that is due and redraws once
+static void prv_refresh_timer_callback(void *data) {
+  refresh_data.timer = NULL;
+  frame_clock_begin();
+  uint64_t now = frame_clock_now();
+  bool redraw = false;
+  for (uint8_t ii = 0; ii < RefreshSourceCount; ii++) {
+    uint64_t deadline = refresh_data.deadlines[ii];
+    if (!deadline || deadline > now + REFRESH_SOURCE_SLACK[ii]) {
+      continue;
+    }
+    // clear before raising the handler, so it can schedule the source again
+    refresh_data.deadlines[ii] = 0;
+    redraw |= refresh_data.handlers[ii] ? refresh_data.handlers[ii]() : true;
+  }
+  if (redraw) {
+    layer_mark_dirty(refresh_data.layer);
+  }
+  prv_refresh_timer_start();
+  frame_clock_end();
+}
+
+// Start the AppTimer for the nearest deadline, or bring it forward if it is sleeping past it
+static void prv_refresh_timer_start(void) {
+  uint64_t deadline = UINT64_MAX;
+  for (uint8_t ii = 0; ii < RefreshSourceCount; ii++) {
+    if (refresh_data.deadlines[ii] && refresh_data.deadlines[ii] < deadline) {
+      deadline = refresh_data.deadlines[ii];
+    }
+  }
+  if (deadline == UINT64_MAX) {
+    return;
+  }
+  uint64_t now = frame_clock_now();
+  uint32_t delay = deadline > now ? deadline - now : 0;
+  if (!refresh_data.timer) {
+    refresh_data.timer = app_timer_register(delay, prv_refresh_timer_callback, NULL);
+    refresh_data.timer_deadline = now + delay;
+  } else if (now + delay < refresh_data.timer_deadline) {
+    app_timer_reschedule(refresh_data.timer, delay);
+    refresh_data.timer_deadline = now + delay;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// API Functions
+//
+
+// Initialize the refresh scheduler
+void refresh_initialize(Layer *layer) { refresh_data.layer = layer; }
+
+// Register the handler raised when a source is due
+void refresh_register_handler(RefreshSource source, RefreshHandler handler) {
+  refresh_data.handlers[source] = handler;
+}
+
+// Schedule a source, keeping its earlier deadline if one is already scheduled
+void refresh_schedule(RefreshSource source, uint32_t delay) {
+  // a deadline of 0 marks an unscheduled source, so never store it
+  uint64_t deadline = frame_clock_now() + delay;
+  if (!refresh_data.deadlines[source] || deadline < refresh_data.deadlines[source]) {
+    refresh_data.deadlines[source] = deadline;
+    prv_refresh_timer_start();
+  }
+}
+
+// Cancel a scheduled source
+void refresh_cancel(RefreshSource source) {
+  // the AppTimer is left running, and finds nothing due if this was the nearest deadline
+  refresh_data.deadlines[source] = 0;
+}
+
+// Cancel every scheduled source and stop the scheduler
+void refresh_terminate(void) {
+  if (refresh_data.timer) {
+    app_timer_cancel(refresh_data.timer);
+    refresh_data.timer = NULL;
+  }
+  memset(refresh_data.deadlines, 0, sizeof(refresh_data.deadlines));
+}
@@ -0,0 +1,48 @@
+//! @file refresh.h
+//! @brief Single scheduler for every reason to redraw the screen
+//!
+//! Owns the only AppTimer used to refresh the screen. Each refresh source keeps
+//! its own deadline, and the AppTimer always sleeps until the nearest of them.
+//! All sources which are due when it fires are handled together, and the layer
+//! is marked dirty at most once for the whole pass.
+//!
+//! @author agent
+//! @date October 16, 2026
+
+#pragma once
+#include <pebble.h>
+
+//! List of reasons the screen is refreshed
+typedef enum RefreshSource {
+  RefreshSourceSecond,
+  RefreshSourceMinute,
+  RefreshSourceExpiry,
+  RefreshSourceAnimation,
+  RefreshSourceInput,
+  RefreshSourceCount
+} RefreshSource;
+
+//! Refresh handler, raised when a source's deadline has passed
+//! @return True if the screen needs to be redrawn
+typedef bool (*RefreshHandler)(void);
+
+//! Initialize the refresh scheduler
+//! @param layer The layer to mark dirty when a redraw is needed
+void refresh_initialize(Layer *layer);
+
+//! Register the handler raised when a source is due, a source without a handler always redraws
+//! @param source The refresh source to register for
+//! @param handler The handler to raise when the source is due
+void refresh_register_handler(RefreshSource source, RefreshHandler handler);
+
+//! Schedule a source, keeping its earlier deadline if one is already scheduled
+//! @param source The refresh source to schedule
+//! @param delay The number of milliseconds from the current frame until the source is due
+void refresh_schedule(RefreshSource source, uint32_t delay);
+
+//! Cancel a scheduled source
+//! @param source The refresh source to cancel
+void refresh_cancel(RefreshSource source);
+
+//! Cancel every scheduled source and stop the scheduler
+void refresh_terminate(void);
@@ -5,6 +5,8 @@
 // size of any string at a certain font size. Also allows to draw
 // some string at the largest size that will fit inside a certain rectangle.
 // All text in this library have half-size kerning on both sides of letters.
+// Characters drawn repeatedly at the same size are rasterized once into
+// bitmaps and blitted, as long as they fit into a memory budget.
 //
 // @author Eric D. Phillips
 // @bug No known bugs
@@ -18,41 +20,102 @@
 //
 
 // general dimensions
-static const int8_t LECO_MAX_POINTS = 14; //< Maximum number of points in a single character
-static const int8_t LECO_HEIGHT = 20;     //< Font size of raw character data
-static const int8_t LECO_KERNING = 4;     //< Spacing between characters
-// unscaled centered point data for all LECO font characters
-static const int8_t LECO_POINTS_X[] = {
-    -7, +7, +7, -7, -7, -3, -3, +3, +3, -3,                 // 0
-    -7, +2, +2, +7, +7, -7, -7, -2, -2, -7,                 // 1
-    -7, +7, +7, -3, -3, +7, +7, -7, -7, +3, +3, -3, -3, -7, // 2
-    -7, +7, +7, -7, -7, +3, +3, -5, -5, +3, +3, -7,         // 3
-    -7, -3, -3, +3, +3, +7, +7, +3, +3, -7,                 // 4
-    -7, +7, +7, -3, -3, +7, +7, -7, -7, -3, -3, +3, +3, -7, // 5
-    +7, -3, -3, +3, +3, -5, -5, +7, +7, -7, -7, +7,         // 6
-    -7, +7, +7, +3, +3, -3, -3, -7,                         // 7
-    -7, -7, +7, +7, -7, -7, +5, +5, -3, -3, +3, +3, -3, -3, // 8
-    -7, +3, +3, -3, -3, +5, +5, -7, -7, +7, +7, -7,         // 9
-    -2, +2, +2, -2,                                         // :
-};
-static const int8_t LECO_POINTS_Y[] = {
-    -10, -10, +10, +10, -10, -10, +6,  +6,  -6,  -6,                    // 0
-    -10, -10, +6,  +6,  +10, +10, +6,  +6,  -6,  -6,                    // 1
-    -10, -10, +2,  +2,  +6,  +6,  +10, +10, -2,  -2,  -6,  -6,  -4, -4, // 2
-    -10, -10, +10, +10, +6,  +6,  +2,  +2,  -2,  -2,  -6,  -6,          // 3
-    -10, -10, -2,  -2,  -10, -10, +10, +10, +2,  +2,                    // 4
-    -10, -10, -6,  -6,  -2,  -2,  +10, +10, +4,  +4,  +6,  +6,  +2, +2, // 5
-    -6,  -6,  +6,  +6,  +2,  +2,  -2,  -2,  +10, +10, -10, -10,         // 6
-    -10, -10, +10, +10, -6,  -6,  -4,  -4,                              // 7
-    +2,  -10, -10, +10, +10, -2,  -2,  +2,  +2,  +6,  +6,  -6,  -6, +2, // 8
-    +6,  +6,  -6,  -6,  -2,  -2,  +2,  +2,  -10, -10, +10, +10,         // 9
-    -2,  -2,  +2,  +2,                                                  // :
+static const int8_t LECO_HEIGHT = 20; //< Font size of raw character data
+static const int8_t LECO_KERNING = 4; //< Spacing between characters
+// unscaled centered data for all LECO font characters, each character is a set of rectangles
+// which only share edges, given as inclusive {x_min, y_min, x_max, y_max} corners
+static const int8_t LECO_RECTS[][4] = {
+    {-7, -10, -3, +10}, {+3, -10, +7, +10}, {-3, -10, +3, -6}, {-3, +6, +3, +10}, // 0
+    {-2, -10, +2, +10}, {-7, -10, -2, -6}, {-7, +6, -2, +10}, {+2, +6, +7, +10}, // 1
+    {-7, -10, +7, -6}, {-7, -2, +7, +2}, {-7, +6, +7, +10}, {-7, +2, -3, +6}, {+3, -6, +7, -2},
+    {-7, -6, -3, -4}, // 2
+    {+3, -10, +7, +10}, {-7, -10, +3, -6}, {-7, +6, +3, +10}, {-5, -2, +3, +2}, // 3
+    {+3, -10, +7, +10}, {-7, -10, -3, +2}, {-3, -2, +3, +2}, // 4
+    {-7, -10, +7, -6}, {-7, -2, +7, +2}, {-7, +6, +7, +10}, {-7, -6, -3, -2}, {+3, +2, +7, +6},
+    {-7, +4, -3, +6}, // 5
+    {-7, -10, -3, +10}, {+3, -2, +7, +10}, {-3, -10, +7, -6}, {-3, -2, +3, +2},
+    {-3, +6, +3, +10}, // 6
+    {+3, -10, +7, +10}, {-7, -10, +3, -6}, {-7, -6, -3, -4}, // 7
+    {-7, -10, -3, +10}, {+3, -10, +7, +10}, {-3, -10, +3, -6}, {-3, -2, +3, +2},
+    {-3, +6, +3, +10}, // 8
+    {+3, -10, +7, +10}, {-7, -10, -3, +2}, {-7, +6, +3, +10}, {-3, -10, +3, -6},
+    {-3, -2, +3, +2}, // 9
+    {-2, -2, +2, +2}, // :
 };
 static const int8_t LECO_COLON_OFFSETS[] = {-4, 8};
-// offsets into point data for the start of every character padded with the count
-static const uint8_t LECO_OFFSETS[] = {0, 10, 20, 34, 46, 56, 70, 82, 90, 104, 116, 120};
+// offsets into rectangle data for the start of every character padded with the count
+static const uint8_t LECO_OFFSETS[] = {0, 4, 8, 14, 18, 21, 27, 32, 35, 40, 45, 46};
 // width of each character
 static const int8_t LECO_WIDTHS[] = {14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 4};
+// character data index of the colon
+#define LECO_COLON_INDEX 10
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Scaled Glyph Cache
+//
+
+#define GLYPH_CACHE_SIZE 12 //< Number of scaled glyphs kept in the cache
+#define GLYPH_MAX_RECTS 6   //< Maximum number of rectangles in a single scaled glyph
+
+// LECO character scaled to a certain font size, with rectangles relative to its center
+typedef struct {
+  int16_t font_size;            //< Font size the glyph was scaled to, 0 if the entry is unused
+  uint8_t char_idx;             //< Character data index of the glyph
+  uint8_t num_rects;            //< Number of rectangles in the glyph
+  int16_t width;                //< Scaled width of the glyph
+  uint32_t last_used;           //< Cache access count when the glyph was last used
+  GRect rects[GLYPH_MAX_RECTS]; //< Scaled rectangles making up the glyph
+} ScaledGlyph;
+
+// Least recently used cache of scaled glyphs
+static struct {
+  ScaledGlyph glyphs[GLYPH_CACHE_SIZE]; //< Cached glyphs
+  uint32_t access_count;                //< Number of cache accesses, used to order the glyphs
+  uint32_t hits;                        //< Number of lookups which found a cached glyph
+  uint32_t misses;                      //< Number of lookups which had to scale the glyph
+} glyph_cache;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Glyph Bitmap Cache
+//
+
+#define GLYPH_BITMAP_SETTLE_COUNT 3    //< Frames in a row at one size before rasterizing
+#define GLYPH_BITMAP_HEAP_RESERVE 4096 //< Heap bytes which must stay free after rasterizing
+#ifdef PBL_PLATFORM_APLITE
+#define GLYPH_BITMAP_BUDGET 2048 //< Maximum bytes of pixel data across all glyph bitmaps
+#else
+#define GLYPH_BITMAP_BUDGET 8192 //< Maximum bytes of pixel data across all glyph bitmaps
+#endif
+// Glyph pixels are set bits, drawn transparently over the background. Color platforms use a
+// palette of {clear, text color}, which packs the leftmost pixel in the most significant bit
+#ifdef PBL_COLOR
+#define GLYPH_BITMAP_FORMAT GBitmapFormat1BitPalette
+#define GLYPH_BITMAP_BIT(x) (0x80 >> ((x) % 8))
+#else
+#define GLYPH_BITMAP_FORMAT GBitmapFormat1Bit
+#define GLYPH_BITMAP_BIT(x) (0x01 << ((x) % 8))
+#endif
+
+// LECO character rasterized at a certain font size
+typedef struct {
+  GBitmap *bitmap;       //< Rasterized glyph, NULL if not rasterized
+  GRect bounds;          //< Bounds of the bitmap relative to the character center
+  uint16_t bytes;        //< Size of the bitmap pixel data
+  int16_t font_size;     //< Font size the bitmap was rasterized at
+  int16_t pending_size;  //< Font size which was most recently drawn without a bitmap
+  uint8_t pending_count; //< Number of frames in a row pending_size has been drawn in
+  uint64_t pending_time; //< Frame time pending_count was last counted at
+} GlyphBitmap;
+
+// One rasterized glyph per character
+static struct {
+  GlyphBitmap glyphs[LECO_COLON_INDEX + 1]; //< Bitmaps for each character
+  uint16_t total_bytes;                     //< Size of the pixel data of all bitmaps
+  GColor color;                             //< Color to draw the glyph bitmaps in
+#ifdef PBL_COLOR
+  GColor palette[2]; //< Palette of {clear, text color} shared by every glyph bitmap
+#endif
+} glyph_bitmaps;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Private Functions
@@ -64,56 +127,190 @@ static uint8_t prv_get_character_index(char character) {
   return character - 48;
 }
 
-// Draws the path both filled and outlined to obtain a better rasterization
-static void prv_gpath_draw_precise(GContext *ctx, GPath *path) {
-  gpath_draw_filled(ctx, path);
-  gpath_draw_outline(ctx, path);
+// Scale the rectangles of a LECO character and append them to a glyph, offset vertically
+static void prv_glyph_add_rects(ScaledGlyph *glyph, uint8_t char_idx, int16_t font_size,
+                                int16_t y_offset) {
+  for (uint8_t idx = LECO_OFFSETS[char_idx]; idx < LECO_OFFSETS[char_idx + 1]; idx++) {
+    // scale each corner the same way the glyph outline used to be, then fill inclusively
+    const int8_t *rect = LECO_RECTS[idx];
+    int16_t x_min = rect[0] * font_size / LECO_HEIGHT;
+    int16_t y_min = rect[1] * font_size / LECO_HEIGHT;
+    int16_t x_max = rect[2] * font_size / LECO_HEIGHT;
+    int16_t y_max = rect[3] * font_size / LECO_HEIGHT;
+    glyph->rects[glyph->num_rects++] =
+        GRect(x_min, y_offset + y_min, x_max - x_min + 1, y_max - y_min + 1);
+  }
 }
 
-// Draw a LECO character
-static void prv_draw_character(GContext *ctx, GPath *path, char character, int16_t font_size) {
-  uint8_t char_idx = prv_get_character_index(character);
-  uint8_t start_offset = LECO_OFFSETS[char_idx];
-  uint8_t end_offset = LECO_OFFSETS[char_idx + 1];
-  // populate the path data points
-  path->num_points = end_offset - start_offset;
-  for (uint8_t ii = 0, idx = start_offset; idx < end_offset; ii++, idx++) {
-    path->points[ii].x = LECO_POINTS_X[idx] * font_size / LECO_HEIGHT;
-    path->points[ii].y = LECO_POINTS_Y[idx] * font_size / LECO_HEIGHT;
+// Scale a LECO character into a glyph with rectangles relative to the character center
+static void prv_glyph_scale(ScaledGlyph *glyph, uint8_t char_idx, int16_t font_size) {
+  glyph->font_size = font_size;
+  glyph->char_idx = char_idx;
+  glyph->num_rects = 0;
+  glyph->width = LECO_WIDTHS[char_idx] * font_size / LECO_HEIGHT;
+  if (char_idx != LECO_COLON_INDEX) {
+    prv_glyph_add_rects(glyph, char_idx, font_size, 0);
+  } else {
+    // colon needs special handling, use the dot twice with different offsets
+    for (uint8_t ii = 0; ii < ARRAY_LENGTH(LECO_COLON_OFFSETS); ii++) {
+      prv_glyph_add_rects(glyph, char_idx, font_size,
+                          LECO_COLON_OFFSETS[ii] * font_size / LECO_HEIGHT);
+    }
+  }
+}
+
+// Get a scaled glyph from the cache, scaling it into the least recently used entry on a miss
+static const ScaledGlyph *prv_glyph_cache_get(uint8_t char_idx, int16_t font_size) {
+  ScaledGlyph *lru_glyph = &glyph_cache.glyphs[0];
+  for (uint8_t ii = 0; ii < GLYPH_CACHE_SIZE; ii++) {
+    ScaledGlyph *glyph = &glyph_cache.glyphs[ii];
+    if (glyph->font_size == font_size && glyph->char_idx == char_idx) {
+      glyph_cache.hits++;
+      glyph->last_used = ++glyph_cache.access_count;
+      return glyph;
+    }
+    if (glyph->last_used < lru_glyph->last_used) {
+      lru_glyph = glyph;
+    }
+  }
+  glyph_cache.misses++;
+  prv_glyph_scale(lru_glyph, char_idx, font_size);
+  lru_glyph->last_used = ++glyph_cache.access_count;
+  return lru_glyph;
+}
+
+// Destroy the bitmap of a rasterized glyph
+static void prv_glyph_bitmap_destroy(GlyphBitmap *glyph_bitmap) {
+  if (glyph_bitmap->bitmap) {
+    gbitmap_destroy(glyph_bitmap->bitmap);
+    glyph_bitmap->bitmap = NULL;
+    glyph_bitmaps.total_bytes -= glyph_bitmap->bytes;
+    glyph_bitmap->bytes = 0;
+  }
+}
+
+// Rasterize a scaled glyph into a bitmap, return false if it does not fit into the memory budget
+static bool prv_glyph_bitmap_rasterize(GlyphBitmap *glyph_bitmap, const ScaledGlyph *glyph) {
+  prv_glyph_bitmap_destroy(glyph_bitmap);
+  // find the bounds of all rectangles in the glyph
+  GRect bounds = glyph->rects[0];
+  for (uint8_t ii = 1; ii < glyph->num_rects; ii++) {
+    GRect rect = glyph->rects[ii];
+    int16_t x_max = bounds.origin.x + bounds.size.w;
+    int16_t y_max = bounds.origin.y + bounds.size.h;
+    bounds.origin.x = rect.origin.x < bounds.origin.x ? rect.origin.x : bounds.origin.x;
+    bounds.origin.y = rect.origin.y < bounds.origin.y ? rect.origin.y : bounds.origin.y;
+    x_max = rect.origin.x + rect.size.w > x_max ? rect.origin.x + rect.size.w : x_max;
+    y_max = rect.origin.y + rect.size.h > y_max ? rect.origin.y + rect.size.h : y_max;
+    bounds.size.w = x_max - bounds.origin.x;
+    bounds.size.h = y_max - bounds.origin.y;
   }
+  // check the memory budget with a word aligned estimate before allocating anything
+  uint16_t bytes = (bounds.size.w + 31) / 32 * 4 * bounds.size.h;
+  if (glyph_bitmaps.total_bytes + bytes > GLYPH_BITMAP_BUDGET ||
+      heap_bytes_free() < (size_t)bytes + GLYPH_BITMAP_HEAP_RESERVE) {
+    return false;
+  }
+#ifdef PBL_COLOR
+  // every bitmap shares one static palette, rather than a heap allocated palette each
+  glyph_bitmaps.palette[0] = GColorClear;
+  glyph_bitmap->bitmap = gbitmap_create_blank_with_palette(bounds.size, GLYPH_BITMAP_FORMAT,
+                                                           glyph_bitmaps.palette, false);
+#else
+  glyph_bitmap->bitmap = gbitmap_create_blank(bounds.size, GLYPH_BITMAP_FORMAT);
+#endif
+  if (!glyph_bitmap->bitmap) {
+    return false;
+  }
+  glyph_bitmap->bounds = bounds;
+  glyph_bitmap->font_size = glyph->font_size;
+  glyph_bitmap->bytes = gbitmap_get_bytes_per_row(glyph_bitmap->bitmap) * bounds.size.h;
+  glyph_bitmaps.total_bytes += glyph_bitmap->bytes;
+  // set the bits of every rectangle, blank bitmaps start out cleared
+  uint8_t *data = gbitmap_get_data(glyph_bitmap->bitmap);
+  uint16_t row_bytes = gbitmap_get_bytes_per_row(glyph_bitmap->bitmap);
+  for (uint8_t ii = 0; ii < glyph->num_rects; ii++) {
+    GRect rect = glyph->rects[ii];
+    rect.origin.x -= bounds.origin.x;
+    rect.origin.y -= bounds.origin.y;
+    for (int16_t y = rect.origin.y; y < rect.origin.y + rect.size.h; y++) {
+      uint8_t *row = data + y * row_bytes;
+      for (int16_t x = rect.origin.x; x < rect.origin.x + rect.size.w; x++) {
+        row[x / 8] |= GLYPH_BITMAP_BIT(x);
+      }
+    }
+  }
+  return true;
+}
+
+// Draw a glyph from its bitmap, rasterizing it once its font size has settled
+// Returns false if the glyph has no bitmap at this size and must be drawn from its rectangles
+static bool prv_glyph_bitmap_draw(GContext *ctx, const ScaledGlyph *glyph, GPoint center) {
+  GlyphBitmap *glyph_bitmap = &glyph_bitmaps.glyphs[glyph->char_idx];
+  if (!glyph_bitmap->bitmap || glyph_bitmap->font_size != glyph->font_size) {
+    // only rasterize sizes which are drawn repeatedly, not sizes passing by during animations
+    // count frames rather than draws, since a character can appear several times in one frame
+    uint64_t now = frame_clock_now();
+    if (glyph_bitmap->pending_size != glyph->font_size) {
+      glyph_bitmap->pending_size = glyph->font_size;
+      glyph_bitmap->pending_count = 0;
+      glyph_bitmap->pending_time = 0;
+    }
+    if (glyph_bitmap->pending_time != now && glyph_bitmap->pending_count < UINT8_MAX) {
+      glyph_bitmap->pending_time = now;
+      glyph_bitmap->pending_count++;
+    }
+    if (glyph_bitmap->pending_count < GLYPH_BITMAP_SETTLE_COUNT ||
+        !prv_glyph_bitmap_rasterize(glyph_bitmap, glyph)) {
+      return false;
+    }
+  }
+  // composite the set bits onto the context in the text color
+  GRect rect = glyph_bitmap->bounds;
+  rect.origin.x += center.x;
+  rect.origin.y += center.y;
+#ifdef PBL_COLOR
+  glyph_bitmaps.palette[1] = glyph_bitmaps.color;
+  graphics_context_set_compositing_mode(ctx, GCompOpSet);
+#else
+  graphics_context_set_compositing_mode(
+      ctx, gcolor_equal(glyph_bitmaps.color, GColorBlack) ? GCompOpClear : GCompOpOr);
+#endif
+  graphics_draw_bitmap_in_rect(ctx, glyph_bitmap->bitmap, rect);
+  graphics_context_set_compositing_mode(ctx, GCompOpAssign);
+  return true;
+}
+
+// Draw a LECO character
+static void prv_draw_character(GContext *ctx, GPoint *cursor, char character, int16_t font_size) {
+  const ScaledGlyph *glyph = prv_glyph_cache_get(prv_get_character_index(character), font_size);
   // calculate the next cursor position
-  int16_t next_x = path->offset.x + LECO_WIDTHS[char_idx] * font_size / LECO_HEIGHT;
+  int16_t next_x = cursor->x + glyph->width;
   // offset to half the character and draw
-  path->offset.x = (path->offset.x + next_x) / 2;
-  if (character != ':') {
-    prv_gpath_draw_precise(ctx, path);
-  } else {
-    // colon needs special handling, draw the dot twice with different offsets
-    int16_t old_y = path->offset.y;
-    path->offset.y = old_y + LECO_COLON_OFFSETS[0] * font_size / LECO_HEIGHT;
-    prv_gpath_draw_precise(ctx, path);
-    path->offset.y = old_y + LECO_COLON_OFFSETS[1] * font_size / LECO_HEIGHT;
-    prv_gpath_draw_precise(ctx, path);
-    path->offset.y = old_y;
+  GPoint center = GPoint((cursor->x + next_x) / 2, cursor->y);
+  if (!prv_glyph_bitmap_draw(ctx, glyph, center)) {
+    for (uint8_t ii = 0; ii < glyph->num_rects; ii++) {
+      GRect rect = glyph->rects[ii];
+      rect.origin.x += center.x;
+      rect.origin.y += center.y;
+      graphics_fill_rect(ctx, rect, 0, GCornerNone);
+    }
   }
   // restore the next cursor position
-  path->offset.x = next_x;
+  cursor->x = next_x;
 }
 
 // Draw the LECO font onto a drawing context at a certain font size
 static void prv_draw_text(GContext *ctx, char *buff, int16_t font_size, GPoint position) {
+  if (font_size <= 0) {
+    return;
+  }
   const int16_t kerning = LECO_KERNING * font_size / LECO_HEIGHT;
   position.x += (kerning + 1) / 2; // Round up to offset truncation
-  // initialize the reusable graphics path
-  GPoint point_data[LECO_MAX_POINTS];
-  GPath path = (GPath){
-      .points = point_data,
-      .offset = position,
-  };
   // loop over characters in buff until NUL character is reached
   for (uint8_t ii = 0; buff[ii] != '\0'; ii++) {
-    prv_draw_character(ctx, &path, buff[ii], font_size);
-    path.offset.x += kerning;
+    prv_draw_character(ctx, &position, buff[ii], font_size);
+    position.x += kerning;
   }
 }
 
@@ -159,13 +356,21 @@ void text_render_draw_text(GContext *ctx, char *buff, int16_t font_size, GPoint
   prv_draw_text(ctx, buff, font_size, position);
 }
 
-// Renders the LECO font at the largest possible size that will fit within a certain size rectangle
-void text_render_draw_scalable_text(GContext *ctx, char *buff, GRect bounds) {
-  if (buff == NULL || buff[0] == '\0' || bounds.size.w <= 0 || bounds.size.h <= 0) {
+// Gets the width of a certain text string at the raw font size
+int16_t text_render_get_unscaled_width(char *buff) {
+  if (buff == NULL) {
+    return 0;
+  }
+  return prv_unscaled_text_width(buff);
+}
+
+// Renders already measured LECO text at the largest possible size that will fit within a rectangle
+void text_render_draw_measured_text(GContext *ctx, char *buff, int16_t total_width, GRect bounds) {
+  if (buff == NULL || buff[0] == '\0' || total_width <= 0 || bounds.size.w <= 0 ||
+      bounds.size.h <= 0) {
     return;
   }
   // calculate the maximum font size which stays within this rectangle
-  int16_t total_width = prv_unscaled_text_width(buff);
   int16_t font_size_w = LECO_HEIGHT * bounds.size.w / total_width;
   int16_t font_size_h = bounds.size.h;
   int16_t font_size = (font_size_h < font_size_w) ? font_size_h : font_size_w;
@@ -176,3 +381,23 @@ void text_render_draw_scalable_text(GContext *ctx, char *buff, GRect bounds) {
   // draw the text onto the graphics context
   prv_draw_text(ctx, buff, font_size, position);
 }
+
+// Set the color of drawn text
+void text_render_set_color(GColor color) { glyph_bitmaps.color = color; }
+
+// Clear the scaled glyph cache
+void text_render_invalidate_cache(void) {
+  for (uint8_t ii = 0; ii < GLYPH_CACHE_SIZE; ii++) {
+    glyph_cache.glyphs[ii].font_size = 0;
+    glyph_cache.glyphs[ii].last_used = 0;
+  }
+  for (uint8_t ii = 0; ii < ARRAY_LENGTH(glyph_bitmaps.glyphs); ii++) {
+    prv_glyph_bitmap_destroy(&glyph_bitmaps.glyphs[ii]);
+  }
+}
+
+// Get the scaled glyph cache statistics
+void text_render_get_cache_stats(uint32_t *hits, uint32_t *misses) {
+  (*hits) = glyph_cache.hits;
+  (*misses) = glyph_cache.misses;
+}
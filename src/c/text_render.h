@@ -5,6 +5,8 @@
 //! size of any string at a certain font size. Also allows to draw
 //! some string at the largest size that will fit inside a certain rectangle.
 //! All text in this library have half-size kerning on both sides of letters.
+//! Characters drawn repeatedly at the same size are rasterized once into
+//! bitmaps and blitted, as long as they fit into a memory budget.
 //!
 //! @author Eric D. Phillips
 //! @bug No known bugs
@@ -29,8 +31,28 @@ int16_t text_render_get_max_font_size(char *buff, GRect size);
 //! @param position The upper right corner of where to begin drawing from
 void text_render_draw_text(GContext *ctx, char *buff, int16_t font_size, GPoint position);
 
-//! Renders the LECO font at the largest possible size that will fit within a certain size rectangle
+//! Gets the width of a certain text string at the raw font size, for use when drawing it repeatedly
+//! @param buff The text string to measure
+//! @return The unscaled width of the text
+int16_t text_render_get_unscaled_width(char *buff);
+
+//! Renders already measured LECO text at the largest possible size that will fit within a certain
+//! size rectangle, so text drawn every frame is only measured when it changes
 //! @param ctx The GContext onto which to draw the text
 //! @param buff The text buffer to draw
+//! @param total_width The unscaled width of the text from text_render_get_unscaled_width
 //! @param bounds The bounds within which to draw the text at maximum size
-void text_render_draw_scalable_text(GContext *ctx, char *buff, GRect bounds);
+void text_render_draw_measured_text(GContext *ctx, char *buff, int16_t total_width, GRect bounds);
+
+//! Set the color of drawn text, which must match the GContext fill color
+//! @param color The color to draw text in
+void text_render_set_color(GColor color);
+
+//! Clear the cache of glyphs scaled and rasterized to specific font sizes, call when the text
+//! layout changes and before exiting
+void text_render_invalidate_cache(void);
+
+//! Get the number of scaled glyph cache lookups which hit and missed since the app started
+//! @param hits A pointer to where to store the number of lookups which found a cached glyph
+//! @param misses A pointer to where to store the number of lookups which had to scale the glyph
+void text_render_get_cache_stats(uint32_t *hits, uint32_t *misses);
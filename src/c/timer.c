@@ -2,7 +2,10 @@
 // @brief Data and controls for timer
 //
 // Contains data and all functions for setting and accessing
-// a timer. Also saves and loads timers between closing and reopening.
+// a table of timers, of which one is selected and shown at a time.
+// Running countdowns are kept in a min-heap by expiry, so the next
+// one to go off is always at the root. Also saves and loads timers
+// between closing and reopening.
 //
 // @author Eric D. Phillips
 // @data October 26, 2015
@@ -11,12 +14,17 @@
 #include "timer.h"
 #include "utility.h"
 
-#define PERSIST_VERSION 2
+#define PERSIST_VERSION 4
 #define PERSIST_VERSION_KEY 4342896
-#define PERSIST_TIMER_KEY 58734
+#define PERSIST_MANIFEST_KEY 58736
+#define PERSIST_TIMER_RECORD_KEY 58740 //< First of TIMER_COUNT consecutive timer record keys
+#define PERSIST_TIMER_RECORD_SIZE 17
+#define PERSIST_MANIFEST_SIZE 2
+#define PERSIST_CRC_SIZE 2
 #define VIBRATION_LENGTH_MS 20000
 // legacy persistent storage
-#define PERSIST_TIMER_KEY_V2 3456
+#define PERSIST_TIMER_KEY_V1 3456
+#define PERSIST_TIMER_KEY_V2 58734
 
 // Vibration sequence
 static const uint32_t vibe_sequence[] = {150, 200, 300};
@@ -29,60 +37,329 @@ static const VibePattern vibe_pattern = {
 typedef struct {
   int64_t length_ms; //< Length of timer in milliseconds
   int64_t start_ms;  //< The start epoch of the timer in milliseconds
-  bool elapsed;      //< Used to start the vibration if first time as elapsed
+  bool elapsed;      //< Set once the first vibration after expiring has started
   bool can_vibrate;  //< Flag used to tell when the timer has completed
 } Timer;
-Timer timer_data;
+
+// Single timer as it was stored raw in version 2
+typedef struct {
+  int64_t length_ms; //< Length of timer in milliseconds
+  int64_t start_ms;  //< The start epoch of the timer in milliseconds
+  bool elapsed;      //< Used to start the vibration if first time as elapsed
+  bool can_vibrate;  //< Flag used to tell when the timer has completed
+} TimerV2;
+
+// Table of timers
+typedef struct {
+  Timer timers[TIMER_COUNT]; //< Every timer in the table
+  uint8_t selected;          //< Index of the selected timer
+} TimerTable;
+
+// Records which have changed since they were last written to persistent storage
+typedef struct {
+  uint8_t timers; //< Bit field of changed timer records
+  bool manifest;  //< If the manifest has changed
+} PersistDirty;
+_Static_assert(TIMER_COUNT <= 8, "Every timer needs a dirty bit");
+
+// Timer table and the selected timer, which all single timer functions act on
+static TimerTable timer_table;
+static Timer *timer_data = &timer_table.timers[0];
+static PersistDirty persist_dirty;
+// Incremented after every change to the timer which is not caused by time passing
+static uint32_t timer_revision;
+
+// Binary min-heap of running countdowns, ordered by expiry epoch
+static struct {
+  uint8_t entries[TIMER_COUNT];  //< Timer indices in heap order
+  int8_t positions[TIMER_COUNT]; //< Heap position of each timer, or -1 if not in the heap
+  uint8_t size;                  //< Number of timers in the heap
+} expiry_heap;
+
+// Most recent snapshot, reused while the frame time and timer revision are unchanged
+static struct {
+  TimerSnapshot snapshot; //< The cached snapshot
+  uint64_t time;          //< The frame time the snapshot was taken at, or 0 if invalid
+  uint32_t revision;      //< The timer revision the snapshot was taken at
+} snapshot_cache;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
-// API Functions
+// Private Functions
 //
 
-// Get timer value divided into time parts
-void timer_get_time_parts(uint16_t *hr, uint16_t *min, uint16_t *sec) {
-  int64_t value = timer_get_value_ms();
-  (*hr) = value / MSEC_IN_HR;
-  (*min) = value % MSEC_IN_HR / MSEC_IN_MIN;
-  (*sec) = value % MSEC_IN_MIN / MSEC_IN_SEC;
-}
-
-// Get the timer time in milliseconds assuming the following conditions
+// Get the signed timer value, which is negative once a countdown has become a stopwatch
 // 1. when the timer is running, start_ms represents the epoch when it was started
 // 2. when it is paused, start_ms represents the negative of the time is has been running
-int64_t timer_get_value_ms(void) {
-  int64_t value =
-      timer_data.length_ms - epoch() + (((timer_data.start_ms + epoch() - 1) % epoch()) + 1);
+static int64_t prv_timer_signed_value(int64_t now) {
+  if (timer_data->start_ms > 0) {
+    return timer_data->length_ms - (now - timer_data->start_ms);
+  }
+  return timer_data->length_ms + timer_data->start_ms;
+}
+
+// Clamp a non-negative millisecond value to 32 bits
+static uint32_t prv_saturate_u32(int64_t value) {
+  return value > (int64_t)UINT32_MAX ? UINT32_MAX : (uint32_t)value;
+}
+
+// Take a snapshot of the timer at a point in time
+static void prv_timer_snapshot_take(TimerSnapshot *snapshot, int64_t now) {
+  int64_t value = prv_timer_signed_value(now);
+  snapshot->chrono = value <= 0;
+  snapshot->paused = timer_data->start_ms <= 0;
+  snapshot->vibrating = snapshot->chrono && !snapshot->paused && timer_data->can_vibrate;
   if (value < 0) {
-    return -value;
+    value = -value;
+  }
+  snapshot->value_ms = prv_saturate_u32(value);
+  snapshot->length_ms = prv_saturate_u32(timer_data->length_ms);
+  // divide into time parts with 32 bit math, unless a stopwatch has run for over 49 days
+  uint32_t remainder;
+  if (value <= (int64_t)UINT32_MAX) {
+    snapshot->hr = snapshot->value_ms / MSEC_IN_HR;
+    remainder = snapshot->value_ms - (uint32_t)snapshot->hr * MSEC_IN_HR;
+  } else {
+    int64_t hr = value / MSEC_IN_HR;
+    snapshot->hr = hr;
+    remainder = value - hr * MSEC_IN_HR;
+  }
+  snapshot->min = remainder / MSEC_IN_MIN;
+  remainder -= (uint32_t)snapshot->min * MSEC_IN_MIN;
+  snapshot->sec = remainder / MSEC_IN_SEC;
+  snapshot->msec = remainder - (uint32_t)snapshot->sec * MSEC_IN_SEC;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Expiry Heap
+//
+
+// Get the epoch a timer's countdown expires at
+static int64_t prv_expiry_key(uint8_t index) {
+  return timer_table.timers[index].start_ms + timer_table.timers[index].length_ms;
+}
+
+// Place a timer at a heap position and record it
+static void prv_expiry_heap_set(uint8_t pos, uint8_t index) {
+  expiry_heap.entries[pos] = index;
+  expiry_heap.positions[index] = pos;
+}
+
+// Move the entry at a heap position up until its parent expires before it
+static void prv_expiry_heap_sift_up(uint8_t pos) {
+  uint8_t index = expiry_heap.entries[pos];
+  int64_t key = prv_expiry_key(index);
+  while (pos > 0) {
+    uint8_t parent = (pos - 1) / 2;
+    if (prv_expiry_key(expiry_heap.entries[parent]) <= key) {
+      break;
+    }
+    prv_expiry_heap_set(pos, expiry_heap.entries[parent]);
+    pos = parent;
+  }
+  prv_expiry_heap_set(pos, index);
+}
+
+// Move the entry at a heap position down until both children expire after it
+static void prv_expiry_heap_sift_down(uint8_t pos) {
+  uint8_t index = expiry_heap.entries[pos];
+  int64_t key = prv_expiry_key(index);
+  for (;;) {
+    uint8_t child = pos * 2 + 1;
+    if (child >= expiry_heap.size) {
+      break;
+    }
+    if (child + 1 < expiry_heap.size &&
+        prv_expiry_key(expiry_heap.entries[child + 1]) <
+            prv_expiry_key(expiry_heap.entries[child])) {
+      child++;
+    }
+    if (key <= prv_expiry_key(expiry_heap.entries[child])) {
+      break;
+    }
+    prv_expiry_heap_set(pos, expiry_heap.entries[child]);
+    pos = child;
   }
-  return value;
+  prv_expiry_heap_set(pos, index);
 }
 
-// Get the total timer time in milliseconds
-int64_t timer_get_length_ms(void) { return timer_data.length_ms; }
+// Remove a timer from the heap, if it is in it
+static void prv_expiry_heap_remove(uint8_t index) {
+  int8_t pos = expiry_heap.positions[index];
+  if (pos < 0) {
+    return;
+  }
+  expiry_heap.positions[index] = -1;
+  expiry_heap.size--;
+  if (pos == expiry_heap.size) {
+    return;
+  }
+  // fill the hole with the last entry, which may need to move either way
+  uint8_t moved = expiry_heap.entries[expiry_heap.size];
+  prv_expiry_heap_set(pos, moved);
+  prv_expiry_heap_sift_up(pos);
+  prv_expiry_heap_sift_down(expiry_heap.positions[moved]);
+}
 
-// Check if the timer is vibrating
-bool timer_is_vibrating(void) {
-  return timer_is_chrono() && !timer_is_paused() && timer_data.can_vibrate;
+// Add, move or remove a timer in the heap after it changed, running countdowns which have not yet
+// gone off belong in the heap
+static void prv_expiry_heap_update(uint8_t index) {
+  Timer *timer = &timer_table.timers[index];
+  bool is_countdown =
+      timer->start_ms > 0 && timer->length_ms > 0 && timer->can_vibrate && !timer->elapsed;
+  int8_t pos = expiry_heap.positions[index];
+  if (!is_countdown) {
+    prv_expiry_heap_remove(index);
+  } else if (pos < 0) {
+    prv_expiry_heap_set(expiry_heap.size++, index);
+    prv_expiry_heap_sift_up(expiry_heap.size - 1);
+  } else {
+    prv_expiry_heap_sift_up(pos);
+    prv_expiry_heap_sift_down(expiry_heap.positions[index]);
+  }
+}
+
+// Rebuild the heap from the whole timer table
+static void prv_expiry_heap_build(void) {
+  expiry_heap.size = 0;
+  memset(expiry_heap.positions, -1, sizeof(expiry_heap.positions));
+  for (uint8_t ii = 0; ii < TIMER_COUNT; ii++) {
+    prv_expiry_heap_update(ii);
+  }
+}
+
+// Record a change to the selected timer
+static void prv_timer_changed(void) {
+  prv_expiry_heap_update(timer_table.selected);
+  persist_dirty.timers |= 1 << timer_table.selected;
+  timer_revision++;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Persistent Records
+//
+
+// Write a record followed by the checksum of its contents
+static void prv_record_write(uint32_t key, uint8_t *buff, size_t size) {
+  uint16_t crc = crc16(buff, size);
+  memcpy(buff + size, &crc, PERSIST_CRC_SIZE);
+  persist_write_data(key, buff, size + PERSIST_CRC_SIZE);
+}
+
+// Read a record, returning false if it is missing, of the wrong size or fails its checksum
+static bool prv_record_read(uint32_t key, uint8_t *buff, size_t size) {
+  if (persist_get_size(key) != (int)(size + PERSIST_CRC_SIZE)) {
+    return false;
+  }
+  persist_read_data(key, buff, size + PERSIST_CRC_SIZE);
+  uint16_t crc;
+  memcpy(&crc, buff + size, PERSIST_CRC_SIZE);
+  return crc == crc16(buff, size);
+}
+
+// Write a timer to its record, packed without padding
+static void prv_timer_record_write(uint8_t index) {
+  Timer *timer = &timer_table.timers[index];
+  uint8_t buff[PERSIST_TIMER_RECORD_SIZE + PERSIST_CRC_SIZE];
+  memcpy(&buff[0], &timer->length_ms, sizeof(timer->length_ms));
+  memcpy(&buff[8], &timer->start_ms, sizeof(timer->start_ms));
+  buff[16] = (uint8_t)timer->elapsed | (uint8_t)timer->can_vibrate << 1;
+  prv_record_write(PERSIST_TIMER_RECORD_KEY + index, buff, PERSIST_TIMER_RECORD_SIZE);
+}
+
+// Read a timer from its record, resetting it if the record is missing or corrupt
+static void prv_timer_record_read(uint8_t index) {
+  Timer *timer = &timer_table.timers[index];
+  uint8_t buff[PERSIST_TIMER_RECORD_SIZE + PERSIST_CRC_SIZE];
+  if (!prv_record_read(PERSIST_TIMER_RECORD_KEY + index, buff, PERSIST_TIMER_RECORD_SIZE)) {
+    *timer = (Timer){0};
+    return;
+  }
+  memcpy(&timer->length_ms, &buff[0], sizeof(timer->length_ms));
+  memcpy(&timer->start_ms, &buff[8], sizeof(timer->start_ms));
+  timer->elapsed = buff[16] & 1;
+  timer->can_vibrate = buff[16] >> 1 & 1;
+}
+
+// Migrate the single raw timer of version 2 into the first timer of the table, returning false if
+// there was nothing to migrate
+static bool prv_persist_migrate(void) {
+  if (!persist_exists(PERSIST_TIMER_KEY_V2)) {
+    return false;
+  }
+  // only trust a record of exactly the old size, otherwise start over with an empty timer
+  TimerV2 timer_v2;
+  if (persist_get_size(PERSIST_TIMER_KEY_V2) == sizeof(timer_v2)) {
+    persist_read_data(PERSIST_TIMER_KEY_V2, &timer_v2, sizeof(timer_v2));
+    timer_table.timers[0] = (Timer){
+        .length_ms = timer_v2.length_ms,
+        .start_ms = timer_v2.start_ms,
+        .elapsed = timer_v2.elapsed,
+        .can_vibrate = timer_v2.can_vibrate,
+    };
+  }
+  persist_delete(PERSIST_TIMER_KEY_V2);
+  // rewrite everything in the current format
+  persist_dirty = (PersistDirty){.timers = (1 << TIMER_COUNT) - 1, .manifest = true};
+  return true;
+}
+
+// Get the timer time in milliseconds
+static int64_t prv_timer_get_value_ms(void) {
+  return llabs(prv_timer_signed_value(frame_clock_now()));
 }
 
 // Check if timer is in stopwatch mode
-bool timer_is_chrono(void) {
-  // see timer_get_timer_parts for explanation of equation
-  return timer_data.length_ms - (int64_t)epoch() +
-             ((timer_data.start_ms + (int64_t)epoch() - 1) % (int64_t)epoch() + 1) <=
-         0;
+static bool prv_timer_is_chrono(void) { return timer_get_snapshot()->chrono; }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// API Functions
+//
+
+// Get the timer state for the current frame
+const TimerSnapshot *timer_get_snapshot(void) {
+  uint64_t now = frame_clock_now();
+  if (snapshot_cache.time != now || snapshot_cache.revision != timer_revision) {
+    prv_timer_snapshot_take(&snapshot_cache.snapshot, now);
+    snapshot_cache.time = now;
+    snapshot_cache.revision = timer_revision;
+  }
+  return &snapshot_cache.snapshot;
 }
 
+// Get timer value divided into time parts
+void timer_get_time_parts(uint16_t *hr, uint16_t *min, uint16_t *sec) {
+  const TimerSnapshot *snapshot = timer_get_snapshot();
+  (*hr) = snapshot->hr;
+  (*min) = snapshot->min;
+  (*sec) = snapshot->sec;
+}
+
+// Check if the timer is vibrating
+bool timer_is_vibrating(void) { return timer_get_snapshot()->vibrating; }
+
 // Check if timer or stopwatch is paused
-bool timer_is_paused(void) { return timer_data.start_ms <= 0; }
+bool timer_is_paused(void) { return timer_data->start_ms <= 0; }
+
+// Get the revision of the timer, which changes whenever the timer is edited
+uint32_t timer_get_revision(void) { return timer_revision; }
 
 // Check if the timer is elapsed and vibrate if this is the first call after elapsing
 void timer_check_elapsed(void) {
-  if (timer_is_vibrating()) {
+  const TimerSnapshot *snapshot = timer_get_snapshot();
+  if (snapshot->vibrating && !timer_data->elapsed) {
+    timer_data->elapsed = true;
+    prv_timer_changed();
+#ifdef BENCHMARK
+    // log how late the first vibration is after the exact expiry, in microseconds like the rest
+    int64_t latency = (int64_t)epoch() - (timer_data->start_ms + timer_data->length_ms);
+    APP_LOG(APP_LOG_LEVEL_INFO, "bench,expiry_latency,1,%d", (int)latency * 1000);
+#endif
+  }
+  if (snapshot->vibrating) {
     // stop vibration after certain duration
-    if (timer_get_value_ms() > VIBRATION_LENGTH_MS) {
-      timer_data.can_vibrate = false;
+    if (snapshot->value_ms > VIBRATION_LENGTH_MS) {
+      timer_data->can_vibrate = false;
+      prv_timer_changed();
     }
     // vibrate
     vibes_enqueue_custom_pattern(vibe_pattern);
@@ -92,7 +369,7 @@ void timer_check_elapsed(void) {
 // Increment timer value currently being edited
 void timer_increment(int64_t increment) {
   // if in paused stopwatch mode, rewind to previous time
-  if (timer_is_chrono() && timer_data.start_ms) {
+  if (prv_timer_is_chrono() && timer_data->start_ms) {
     timer_rewind();
     return;
   }
@@ -106,74 +383,155 @@ void timer_increment(int64_t increment) {
     interval = MSEC_IN_HR * 100;
   }
   // calculate new time by incrementing with wrapping
-  int64_t ls_bit = (timer_data.length_ms + timer_data.start_ms) % interval;
+  int64_t ls_bit = (timer_data->length_ms + timer_data->start_ms) % interval;
   int64_t step = (ls_bit + interval + increment) % interval - ls_bit;
-  if (timer_data.start_ms) {
-    timer_data.start_ms += step;
-    if (timer_data.start_ms > 0) {
-      timer_data.length_ms += timer_data.start_ms;
-      timer_data.start_ms = 0;
+  if (timer_data->start_ms) {
+    timer_data->start_ms += step;
+    if (timer_data->start_ms > 0) {
+      timer_data->length_ms += timer_data->start_ms;
+      timer_data->start_ms = 0;
     }
   } else {
-    timer_data.length_ms += step;
+    timer_data->length_ms += step;
   }
   // if at zero, remove any leftover milliseconds
-  if (timer_get_value_ms() < MSEC_IN_SEC) {
+  if (prv_timer_get_value_ms() < MSEC_IN_SEC) {
     timer_reset();
   }
   // enable vibration
-  if (timer_data.length_ms) {
-    timer_data.can_vibrate = true;
+  if (timer_data->length_ms) {
+    timer_data->can_vibrate = true;
   }
+  timer_data->elapsed = false;
+  prv_timer_changed();
 }
 
 // Toggle play pause state for timer
 void timer_toggle_play_pause(void) {
-  if (timer_data.start_ms > 0) {
-    timer_data.start_ms -= epoch();
+  if (timer_data->start_ms > 0) {
+    timer_data->start_ms -= frame_clock_now();
   } else {
-    timer_data.start_ms += epoch();
+    timer_data->start_ms += frame_clock_now();
   }
+  prv_timer_changed();
 }
 
 //! Rewind the timer back to its original value
 void timer_rewind(void) {
-  timer_data.start_ms = 0;
+  timer_data->start_ms = 0;
   // enable vibration
-  if (timer_data.length_ms) {
-    timer_data.can_vibrate = true;
+  if (timer_data->length_ms) {
+    timer_data->can_vibrate = true;
   }
+  timer_data->elapsed = false;
+  prv_timer_changed();
 }
 
 // Reset the timer to zero
 void timer_reset(void) {
-  timer_data.length_ms = 0;
-  timer_data.start_ms = 0;
+  timer_data->length_ms = 0;
+  timer_data->start_ms = 0;
   // disable vibration
-  timer_data.can_vibrate = false;
+  timer_data->can_vibrate = false;
+  timer_data->elapsed = false;
+  prv_timer_changed();
+}
+
+// Get the index of the selected timer
+uint8_t timer_get_selected(void) { return timer_table.selected; }
+
+// Select which timer in the table is shown and edited
+void timer_select(uint8_t index) {
+  index %= TIMER_COUNT;
+  if (index != timer_table.selected) {
+    persist_dirty.manifest = true;
+  }
+  timer_table.selected = index;
+  timer_data = &timer_table.timers[timer_table.selected];
+  timer_revision++;
 }
 
-// Save the timer to persistent storage
+// Get the epoch of the earliest countdown expiry among all timers
+int64_t timer_get_next_expiry_ms(void) {
+  return expiry_heap.size ? prv_expiry_key(expiry_heap.entries[0]) : 0;
+}
+
+// Select the earliest expired countdown, taking only it out of the heap so that any other expired
+// countdowns are still handled by the following expiry passes
+bool timer_select_expired(void) {
+  if (!expiry_heap.size || prv_expiry_key(expiry_heap.entries[0]) > (int64_t)frame_clock_now()) {
+    return false;
+  }
+  uint8_t expired = expiry_heap.entries[0];
+  prv_expiry_heap_remove(expired);
+  timer_select(expired);
+  return true;
+}
+
+// Select the countdown which expires next among all timers
+bool timer_select_next_expiry(void) {
+  if (!expiry_heap.size) {
+    return false;
+  }
+  timer_select(expiry_heap.entries[0]);
+  return true;
+}
+
+// Get the number of timers and stopwatches in the table which are running
+uint8_t timer_get_running_count(void) {
+  uint8_t count = 0;
+  for (uint8_t ii = 0; ii < TIMER_COUNT; ii++) {
+    count += timer_table.timers[ii].start_ms > 0;
+  }
+  return count;
+}
+
+// Save the timers to persistent storage, only writing records which have changed
 void timer_persist_store(void) {
-  // write out current persistent data version for potential future reference
-  persist_write_int(PERSIST_VERSION_KEY, PERSIST_VERSION);
-  persist_write_data(PERSIST_TIMER_KEY, &timer_data, sizeof(timer_data));
+  for (uint8_t ii = 0; ii < TIMER_COUNT; ii++) {
+    if (persist_dirty.timers & 1 << ii) {
+      prv_timer_record_write(ii);
+    }
+  }
+  if (persist_dirty.manifest) {
+    // the manifest lists how many records there are, so the table can grow in later versions
+    uint8_t buff[PERSIST_MANIFEST_SIZE + PERSIST_CRC_SIZE] = {TIMER_COUNT, timer_table.selected};
+    prv_record_write(PERSIST_MANIFEST_KEY, buff, PERSIST_MANIFEST_SIZE);
+    // write out current persistent data version for potential future reference
+    persist_write_int(PERSIST_VERSION_KEY, PERSIST_VERSION);
+  }
+  persist_dirty = (PersistDirty){0};
 }
 
-// Read the timer from persistent storage
+// Read the timers from persistent storage
 void timer_persist_read(void) {
+  prv_expiry_heap_build();
   // read legacy version
-  if (persist_exists(PERSIST_TIMER_KEY_V2)) {
-    persist_delete(PERSIST_TIMER_KEY_V2);
+  if (persist_exists(PERSIST_TIMER_KEY_V1)) {
+    persist_delete(PERSIST_TIMER_KEY_V1);
     if (launch_reason() == APP_LAUNCH_WAKEUP) {
       timer_increment(5000);
       timer_toggle_play_pause();
     }
   }
-  // read current version
-  if (persist_exists(PERSIST_TIMER_KEY)) {
-    persist_read_data(PERSIST_TIMER_KEY, &timer_data, sizeof(timer_data));
-  } else {
-    timer_reset();
+  // read current version, or migrate an older one
+  persist_dirty = (PersistDirty){0};
+  if (!prv_persist_migrate()) {
+    uint8_t buff[PERSIST_MANIFEST_SIZE + PERSIST_CRC_SIZE];
+    bool has_manifest = prv_record_read(PERSIST_MANIFEST_KEY, buff, PERSIST_MANIFEST_SIZE);
+    // only read as many records as the manifest lists, any others are left over from elsewhere
+    uint8_t record_count = has_manifest ? buff[0] : TIMER_COUNT;
+    for (uint8_t ii = 0; ii < TIMER_COUNT; ii++) {
+      if (ii < record_count) {
+        prv_timer_record_read(ii);
+      } else {
+        timer_table.timers[ii] = (Timer){0};
+        persist_dirty.timers |= 1 << ii;
+      }
+    }
+    timer_table.selected = has_manifest ? buff[1] % TIMER_COUNT : 0;
+    persist_dirty.manifest = !has_manifest || record_count != TIMER_COUNT;
   }
+  timer_select(timer_table.selected);
+  prv_expiry_heap_build();
 }
@@ -2,7 +2,8 @@
 //! @brief Data and controls for timer
 //!
 //! Contains data and all functions for setting and accessing
-//! a timer. Also saves and loads timers between closing and reopening.
+//! a table of timers, of which one is selected and shown at a time.
+//! Also saves and loads timers between closing and reopening.
 //!
 //! @author Eric D. Phillips
 //! @data October 26, 2015
@@ -10,32 +11,45 @@
 
 #include <pebble.h>
 
+//! Number of timers which can run at once
+#define TIMER_COUNT 4
+
+//! Timer state taken from a single clock read
+typedef struct {
+  uint32_t value_ms;  //< The timer value in milliseconds, saturated at UINT32_MAX
+  uint32_t length_ms; //< The total timer length in milliseconds, saturated at UINT32_MAX
+  uint16_t hr;        //< The hours part of the timer value
+  uint16_t min;       //< The minutes part of the timer value
+  uint16_t sec;       //< The seconds part of the timer value
+  uint16_t msec;      //< The milliseconds part of the timer value
+  bool chrono;        //< If the timer is counting up as a stopwatch
+  bool paused;        //< If the timer is paused
+  bool vibrating;     //< If the timer is currently vibrating
+} TimerSnapshot;
+
+//! Get the timer state for the current frame, which is only recalculated when the frame time
+//! or timer changes
+//! @return A pointer to the snapshot, valid until the timer or frame time next changes
+const TimerSnapshot *timer_get_snapshot(void);
+
 //! Get timer value
 //! @param hr A pointer to where to store the hour value of the timer
 //! @param min A pointer to where to store the minute value of the timer
 //! @param sec A pointer to where to store the second value of the timer
 void timer_get_time_parts(uint16_t *hr, uint16_t *min, uint16_t *sec);
 
-//! Get the timer time in milliseconds
-//! @return The current value of the timer in milliseconds
-int64_t timer_get_value_ms(void);
-
-//! Get the total timer time in milliseconds
-//! @return The total value of the timer in milliseconds
-int64_t timer_get_length_ms(void);
-
 //! Check if the timer is vibrating
 //! @return True if the timer is currently vibrating
 bool timer_is_vibrating(void);
 
-//! Check if timer is in stopwatch mode
-//! @return True if it is counting up as a stopwatch
-bool timer_is_chrono(void);
-
 //! Check if timer or stopwatch is paused
 //! @return True if the timer is paused
 bool timer_is_paused(void);
 
+//! Get the revision of the timer, which changes when the timer is edited but not as time passes
+//! @return The current revision of the timer
+uint32_t timer_get_revision(void);
+
 //! Check if the timer is elapsed and vibrate if this is the first call after elapsing
 void timer_check_elapsed(void);
 
@@ -52,8 +66,33 @@ void timer_rewind(void);
 //! Reset the timer to zero
 void timer_reset(void);
 
-//! Save the timer to persistent storage
+//! Get the index of the selected timer, which every other timer function acts on
+//! @return The index of the selected timer
+uint8_t timer_get_selected(void);
+
+//! Select which timer in the table is shown and edited
+//! @param index The index of the timer to select, wrapped to the number of timers
+void timer_select(uint8_t index);
+
+//! Get the epoch of the earliest countdown expiry among all timers
+//! @return The expiry in milliseconds, or 0 if no countdowns are running
+int64_t timer_get_next_expiry_ms(void);
+
+//! Select the earliest expired countdown among all timers and stop tracking its expiry. Any other
+//! expired countdowns are left for the next call
+//! @return True if a countdown had expired and was selected
+bool timer_select_expired(void);
+
+//! Select the countdown which expires next among all timers
+//! @return True if any countdown is running and was selected
+bool timer_select_next_expiry(void);
+
+//! Get the number of timers and stopwatches in the table which are running
+//! @return The number of running timers
+uint8_t timer_get_running_count(void);
+
+//! Save the timers to persistent storage
 void timer_persist_store(void);
 
-//! Read the timer from persistent storage
+//! Read the timers from persistent storage
 void timer_persist_read(void);
@@ -71,6 +71,14 @@ void graphics_fill_rect_grey(GContext *ctx, GRect rect) {
   // draw grey rectangle with bitmap
   graphics_draw_bitmap_in_rect(ctx, grey_bmp, rect);
 }
+
+// Destroy the bitmap used to fill with "grey"
+void graphics_fill_rect_grey_destroy(void) {
+  if (grey_bmp) {
+    gbitmap_destroy(grey_bmp);
+    grey_bmp = NULL;
+  }
+}
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -78,7 +86,7 @@ void graphics_fill_rect_grey(GContext *ctx, GRect rect) {
 //
 
 // Malloc with built in pointer check
-void *malloc_check(uint16_t size, const char *file, int line) {
+void *malloc_check(size_t size, const char *file, int line) {
   void *ptr = malloc(size);
   if (ptr == NULL) {
     APP_LOG(APP_LOG_LEVEL_ERROR, "Invalid pointer: (%s:%d)", file, line);
@@ -91,3 +99,189 @@ void *malloc_check(uint16_t size, const char *file, int line) {
 
 // Get current epoch in milliseconds
 uint64_t epoch(void) { return (uint64_t)time(NULL) * 1000 + (uint64_t)time_ms(NULL, NULL); }
+
+// Calculate the CRC-16/CCITT-FALSE checksum of a block of data
+uint16_t crc16(const void *data, size_t length) {
+  // computed bitwise, since only a few small records are ever checked
+  const uint8_t *bytes = data;
+  uint16_t crc = 0xFFFF;
+  for (size_t ii = 0; ii < length; ii++) {
+    crc ^= (uint16_t)bytes[ii] << 8;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Frame Clock
+//
+
+static uint64_t frame_epoch = 0; //< Epoch sampled at the start of the outermost frame
+static uint8_t frame_depth = 0;  //< Number of currently nested frames
+
+// Begin a frame, sampling the epoch once
+void frame_clock_begin(void) {
+  if (frame_depth++ == 0) {
+    frame_epoch = epoch();
+  }
+}
+
+// End the current frame
+void frame_clock_end(void) {
+  ASSERT(frame_depth > 0);
+  frame_depth--;
+#ifdef HEAP_INSTRUMENTATION
+  heap_stats_sample();
+#endif
+}
+
+// Get the epoch sampled at the start of the current frame
+uint64_t frame_clock_now(void) { return frame_depth ? frame_epoch : epoch(); }
+
+#ifdef HEAP_INSTRUMENTATION
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Heap Instrumentation
+//
+
+#define HEAP_SITE_COUNT 16 //< Maximum number of distinct MALLOC call sites tracked
+
+// Header stored in front of every instrumented allocation, padded to keep the block aligned
+typedef union {
+  struct {
+    uint32_t size; //< Requested size of the allocation
+    uint8_t site;  //< Index of the call site which made the allocation
+  } info;
+  uint64_t align; //< Keeps the returned block 8 byte aligned
+} HeapHeader;
+
+// Allocations made from one MALLOC call site
+typedef struct {
+  const char *file; //< File of the call site, NULL if unused
+  int line;         //< Line of the call site
+  uint32_t count;   //< Total number of allocations made
+  uint16_t live;    //< Number of allocations not yet freed
+  uint32_t bytes;   //< Bytes of allocations not yet freed
+} HeapSite;
+
+// Heap statistics
+static struct {
+  HeapSite sites[HEAP_SITE_COUNT]; //< Allocations of each call site
+  uint32_t live_bytes;             //< Bytes of instrumented allocations not yet freed
+  uint32_t high_water_bytes;       //< Largest live_bytes has been
+  uint32_t system_baseline;        //< System heap bytes used when heap_stats_begin was called
+  uint32_t system_high_water;      //< Largest system heap bytes used sampled
+  time_t churn_second;             //< Second the current churn count belongs to
+  uint16_t churn_count;            //< Allocations and frees so far this second
+  uint16_t churn_last;             //< Allocations and frees during the last complete second
+  uint16_t churn_peak;             //< Most allocations and frees in any one second
+} heap_stats;
+
+// Find the index of a call site, adding it if new, or HEAP_SITE_COUNT if the table is full
+static uint8_t prv_heap_site_index(const char *file, int line) {
+  uint8_t idx = 0;
+  for (; idx < HEAP_SITE_COUNT && heap_stats.sites[idx].file; idx++) {
+    if (heap_stats.sites[idx].file == file && heap_stats.sites[idx].line == line) {
+      return idx;
+    }
+  }
+  if (idx < HEAP_SITE_COUNT) {
+    heap_stats.sites[idx] = (HeapSite){.file = file, .line = line};
+  }
+  return idx;
+}
+
+// Count an allocation or free towards the churn of the current second
+static void prv_heap_churn(void) {
+  time_t now = time(NULL);
+  if (now != heap_stats.churn_second) {
+    heap_stats.churn_last = now == heap_stats.churn_second + 1 ? heap_stats.churn_count : 0;
+    heap_stats.churn_second = now;
+    heap_stats.churn_count = 0;
+  }
+  heap_stats.churn_count++;
+  if (heap_stats.churn_count > heap_stats.churn_peak) {
+    heap_stats.churn_peak = heap_stats.churn_count;
+  }
+}
+
+// Malloc with failure check which tracks live bytes and the call site
+void *heap_malloc(size_t size, const char *file, int line) {
+  HeapHeader *header = malloc_check(sizeof(HeapHeader) + size, file, line);
+  uint8_t site = prv_heap_site_index(file, line);
+  header->info.size = size;
+  header->info.site = site;
+  if (site < HEAP_SITE_COUNT) {
+    heap_stats.sites[site].count++;
+    heap_stats.sites[site].live++;
+    heap_stats.sites[site].bytes += size;
+  }
+  heap_stats.live_bytes += size;
+  if (heap_stats.live_bytes > heap_stats.high_water_bytes) {
+    heap_stats.high_water_bytes = heap_stats.live_bytes;
+  }
+  prv_heap_churn();
+  heap_stats_sample();
+  return header + 1;
+}
+
+// Free memory allocated with heap_malloc
+void heap_free(void *ptr) {
+  if (!ptr) {
+    return;
+  }
+  HeapHeader *header = (HeapHeader *)ptr - 1;
+  if (header->info.site < HEAP_SITE_COUNT) {
+    heap_stats.sites[header->info.site].live--;
+    heap_stats.sites[header->info.site].bytes -= header->info.size;
+  }
+  heap_stats.live_bytes -= header->info.size;
+  prv_heap_churn();
+  free(header);
+}
+
+// Record the current system heap usage as the baseline for leak reports
+void heap_stats_begin(void) {
+  heap_stats.system_baseline = heap_bytes_used();
+  heap_stats.system_high_water = heap_stats.system_baseline;
+}
+
+// Sample the system heap usage for its high-water mark
+void heap_stats_sample(void) {
+  uint32_t used = heap_bytes_used();
+  if (used > heap_stats.system_high_water) {
+    heap_stats.system_high_water = used;
+  }
+}
+
+// Log the heap statistics and the allocations of each call site
+void heap_stats_log(void) {
+  heap_stats_sample();
+  APP_LOG(APP_LOG_LEVEL_INFO, "heap: used %d, free %d, high water %d",
+          (int)heap_bytes_used(), (int)heap_bytes_free(), (int)heap_stats.system_high_water);
+  APP_LOG(APP_LOG_LEVEL_INFO, "heap: MALLOC live %d, high water %d, churn %d/s, peak %d/s",
+          (int)heap_stats.live_bytes, (int)heap_stats.high_water_bytes,
+          (int)heap_stats.churn_last, (int)heap_stats.churn_peak);
+  for (uint8_t ii = 0; ii < HEAP_SITE_COUNT && heap_stats.sites[ii].file; ii++) {
+    HeapSite *site = &heap_stats.sites[ii];
+    APP_LOG(APP_LOG_LEVEL_INFO, "heap: %s:%d count %d, live %d (%d bytes)", site->file,
+            site->line, (int)site->count, (int)site->live, (int)site->bytes);
+  }
+}
+
+// Log every call site with live allocations and any system heap growth since heap_stats_begin
+void heap_stats_report_leaks(void) {
+  for (uint8_t ii = 0; ii < HEAP_SITE_COUNT && heap_stats.sites[ii].file; ii++) {
+    HeapSite *site = &heap_stats.sites[ii];
+    if (site->live) {
+      APP_LOG(APP_LOG_LEVEL_WARNING, "heap leak: %s:%d, %d allocations (%d bytes)", site->file,
+              site->line, (int)site->live, (int)site->bytes);
+    }
+  }
+  int32_t growth = (int32_t)heap_bytes_used() - (int32_t)heap_stats.system_baseline;
+  if (growth > 0) {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "heap leak: %d system heap bytes not released", (int)growth);
+  }
+}
+#endif
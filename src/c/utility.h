@@ -31,6 +31,9 @@ void graphics_fill_radial(GContext *ctx, GRect bounds, uint8_t fill_mode, int16_
 #ifdef PBL_BW
 //! Fill GRect with "grey" on Aplite
 void graphics_fill_rect_grey(GContext *ctx, GRect rect);
+
+//! Destroy the bitmap used to fill with "grey"
+void graphics_fill_rect_grey_destroy(void);
 #endif
 
 //! Standard assertion definition
@@ -45,16 +48,69 @@ void graphics_fill_rect_grey(GContext *ctx, GRect rect);
   }
 #endif
 
+#ifdef HEAP_INSTRUMENTATION
+//! Malloc with failure check, tracked per call site
+//! @param size The size of the memory to allocate
+#define MALLOC(size) heap_malloc(size, __FILE__, __LINE__)
+//! Free memory allocated with MALLOC
+//! @param ptr The pointer to free
+#define FREE(ptr) heap_free(ptr)
+#else
 //! Malloc with failure check
 //! @param size The size of the memory to allocate
 #define MALLOC(size) malloc_check(size, __FILE__, __LINE__)
+//! Free memory allocated with MALLOC
+//! @param ptr The pointer to free
+#define FREE(ptr) free(ptr)
+#endif
 
 //! Malloc with failure check
 //! @param size The size of the memory to allocate
 //! @param file The name of the file it is called from
 //! @param line The line number it is called from
-void *malloc_check(uint16_t size, const char *file, int line);
+void *malloc_check(size_t size, const char *file, int line);
 
 //! Get current epoch in milliseconds
 //! @return The current epoch time in milliseconds
 uint64_t epoch(void);
+
+//! Calculate the CRC-16/CCITT-FALSE checksum of a block of data
+//! @param data The data to checksum
+//! @param length The number of bytes of data
+//! @return The checksum
+uint16_t crc16(const void *data, size_t length);
+
+//! Begin a frame, sampling the epoch once for every frame clock query until the frame ends.
+//! Frames may be nested, in which case the outermost frame's sample is used
+void frame_clock_begin(void);
+
+//! End the current frame, after which the frame clock reads the live epoch again
+void frame_clock_end(void);
+
+//! Get the epoch sampled at the start of the current frame
+//! @return The frame epoch in milliseconds, or the current epoch if no frame is active
+uint64_t frame_clock_now(void);
+
+#ifdef HEAP_INSTRUMENTATION
+//! Malloc with failure check which tracks live bytes and the call site
+//! @param size The size of the memory to allocate
+//! @param file The name of the file it is called from
+//! @param line The line number it is called from
+void *heap_malloc(size_t size, const char *file, int line);
+
+//! Free memory allocated with heap_malloc
+//! @param ptr The pointer to free
+void heap_free(void *ptr);
+
+//! Record the current system heap usage as the baseline for leak reports
+void heap_stats_begin(void);
+
+//! Sample the system heap usage for its high-water mark
+void heap_stats_sample(void);
+
+//! Log the heap statistics and the allocations of each call site
+void heap_stats_log(void);
+
+//! Log every call site with live allocations and any system heap growth since heap_stats_begin
+void heap_stats_report_leaks(void);
+#endif